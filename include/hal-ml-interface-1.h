@@ -52,6 +52,10 @@ typedef struct _hal_backend_ml_funcs {
   int (*get_model_info) (void *backend_private, int ops, void *in_info, void *out_info);
   /**< Handle event */
   int (*event_handler) (void *backend_private, int ops, void *data);
+  /**< Cancel the ongoing invoke (optional). This is called from another thread while invoke is running, and should make invoke return promptly. It is called with a lock of HAL ML held, so it should not block nor call HAL ML. A cancel after invoke has returned should be ignored, not applied to the next invoke. */
+  int (*cancel) (void *backend_private);
+  /**< Get the sizes of the input and output tensors of the configured model (optional). HAL ML caches them until the instance is configured again or invoke_dynamic is called. */
+  int (*get_tensors_layout) (void *backend_private, hal_ml_tensors_layout_s *in_layout, hal_ml_tensors_layout_s *out_layout);
 } hal_backend_ml_funcs;
 
 /**
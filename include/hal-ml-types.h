@@ -17,6 +17,7 @@
 #define __HAL_ML_TYPES__
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -41,8 +42,143 @@ typedef enum hal_ml_error {
   HAL_ML_ERROR_PERMISSION_DENIED = -5,    /**< Permission denied */
   HAL_ML_ERROR_IO_ERROR = -6,             /**< I/O error */
   HAL_ML_ERROR_RUNTIME_ERROR = -7,        /**< Runtime error */
+  HAL_ML_ERROR_TIMED_OUT = -8,            /**< The request did not complete before its deadline */
+  HAL_ML_ERROR_CANCELED = -9,             /**< The request was canceled */
 } hal_ml_error_e;
 
+/**
+ * @brief The maximum number of tensors in a tensor memory array.
+ * @since HAL_MODULE_ML 1.0
+ */
+#define HAL_ML_TENSOR_SIZE_LIMIT (256)
+
+/**
+ * @brief The memory of a tensor. This has the same layout as GstTensorMemory of NNStreamer,
+ *        so an array of it can be passed as the input or output of hal_ml_request_invoke().
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef struct _hal_ml_tensor_memory_s {
+  void *data;   /**< The data of the tensor */
+  size_t size;  /**< The size of the data in bytes */
+} hal_ml_tensor_memory_s;
+
+/**
+ * @brief The number and byte sizes of the tensors a model consumes or produces.
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef struct _hal_ml_tensors_layout_s {
+  unsigned int num_tensors;                 /**< The number of tensors */
+  size_t size[HAL_ML_TENSOR_SIZE_LIMIT];    /**< The size of each tensor in bytes */
+} hal_ml_tensors_layout_s;
+
+/**
+ * @brief Enumeration for what the streaming mode does with a new frame when its queue is full.
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef enum hal_ml_stream_policy {
+  HAL_ML_STREAM_POLICY_DROP_OLDEST = 0,   /**< Drop the oldest queued frame to make room */
+  HAL_ML_STREAM_POLICY_KEEP_LATEST = 1,   /**< Drop all queued frames, so only the newest one waits */
+  HAL_ML_STREAM_POLICY_BLOCK = 2,         /**< Block the producer until there is room */
+} hal_ml_stream_policy_e;
+
+/**
+ * @brief Counters of the streaming mode.
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef struct _hal_ml_stream_stats_s {
+  uint64_t pushed;      /**< The number of frames pushed */
+  uint64_t processed;   /**< The number of frames invoked */
+  uint64_t dropped;     /**< The number of frames dropped without being invoked */
+} hal_ml_stream_stats_s;
+
+/**
+ * @brief The prefix of the backend name for hal_ml_create() to use a shared instance of hal-ml daemon.
+ * @since HAL_MODULE_ML 1.0
+ */
+#define HAL_ML_DAEMON_PREFIX "daemon:"
+
+/**
+ * @brief The environment variable which overrides the socket path of hal-ml daemon for clients.
+ * @since HAL_MODULE_ML 1.0
+ */
+#define HAL_ML_DAEMON_SOCKET_ENV "HAL_ML_DAEMON_SOCKET"
+
+/**
+ * @brief The default socket path of hal-ml daemon.
+ * @since HAL_MODULE_ML 1.0
+ */
+#define HAL_ML_DAEMON_DEFAULT_SOCKET "/run/hal-ml/daemon.sock"
+
+/**
+ * @brief Counters of hal-ml-mux instance.
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef struct _hal_ml_mux_stats_s {
+  uint64_t hits;            /**< The number of invokes on a resident model */
+  uint64_t misses;          /**< The number of invokes which had to load the model */
+  uint64_t evictions;       /**< The number of models unloaded to make room */
+  uint64_t prefetches;      /**< The number of models loaded ahead of their request */
+  uint64_t prefetch_hits;   /**< The number of prefetched models requested before being evicted */
+  unsigned int resident;    /**< The number of resident models */
+  size_t memory_used;       /**< The sum of the memory costs of the resident models */
+} hal_ml_mux_stats_s;
+
+/**
+ * @brief Enumeration for what hal_ml_create_auto() optimizes when it chooses a backend.
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef enum hal_ml_auto_objective {
+  HAL_ML_AUTO_OBJECTIVE_LATENCY = 0,      /**< The lowest median time of an invoke */
+  HAL_ML_AUTO_OBJECTIVE_THROUGHPUT = 1,   /**< The most back-to-back invokes per second, i.e. the lowest mean time including outliers */
+} hal_ml_auto_objective_e;
+
+/**
+ * @brief The environment variable which overrides the path of the backend profile cache of hal_ml_create_auto().
+ * @since HAL_MODULE_ML 1.0
+ */
+#define HAL_ML_PROFILE_CACHE_ENV "HAL_ML_PROFILE_CACHE"
+
+/**
+ * @brief Where the threads hal-ml runs for a handle, and the buffers it allocates for it, are placed.
+ * @since HAL_MODULE_ML 1.0
+ * @details The threads are the invoke worker of hal_ml_request_invoke_timeout(), the streaming mode,
+ *          the pipeline stages and hal-ml daemon. Threads of the caller are never moved.
+ */
+typedef struct _hal_ml_placement_s {
+  const char *cpus;   /**< The CPUs for the threads in the cpulist format of Linux, e.g. "0-3,8". NULL for any CPU */
+  int numa_node;      /**< The NUMA node for the threads and the buffers, or -1 for no binding */
+  int isolated;       /**< Non-zero to pin each thread to a CPU of its own, which other placed threads of hal-ml avoid */
+} hal_ml_placement_s;
+
+/**
+ * @brief Counters of the invokes of a handle with a placement.
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef struct _hal_ml_placement_stats_s {
+  uint64_t invokes;         /**< The number of invokes observed since the placement was set */
+  uint64_t migrations;      /**< The number of times an invoking thread was found on another CPU than at its previous observation for the handle */
+  uint64_t remote_invokes;  /**< The number of invokes run on another NUMA node than the memory of their first input or output tensor */
+} hal_ml_placement_stats_s;
+
+/**
+ * @brief The split of a tensor into tiles for hal_ml_request_invoke_tiled().
+ * @since HAL_MODULE_ML 1.0
+ * @details The input tensor is seen as [outer][length][in_stride bytes] and the output tensor as
+ *          [outer][length][out_stride bytes], so an output step comes from the input step at the same index.
+ *          For example, an NHWC image tiled along H has outer 1, length H and in_stride W * C * element size.
+ *          Each tile covers @a tile steps and the model sees @a overlap more steps on each side of it,
+ *          so the model input is [outer][tile + 2 * overlap][in_stride bytes].
+ */
+typedef struct _hal_ml_tiling_s {
+  size_t outer;         /**< The number of slices before the axis, the product of the outer dimensions */
+  size_t length;        /**< The number of steps of the whole tensor along the axis */
+  size_t in_stride;     /**< The bytes of one input step, the product of the inner dimensions and the element size */
+  size_t out_stride;    /**< The bytes of one output step */
+  size_t tile;          /**< The number of steps each tile contributes to the output */
+  size_t overlap;       /**< The steps of context on each side of a tile. Their outputs are dropped */
+  unsigned int in_flight; /**< The number of tiles being prepared, invoked or stitched at once */
+} hal_ml_tiling_s;
+
 /**
  * @}
  */
@@ -81,6 +81,10 @@ int hal_ml_param_set (hal_ml_param_h param, const char *key, void *value);
  * @brief Creates hal-ml instance
  * @since HAL_MODULE_ML 1.0
  * @remarks The @a handle should be released using hal_ml_destroy().
+ * @remarks If @a backend_name is #HAL_ML_DAEMON_PREFIX followed by an instance name, the handle forwards
+ *          its invokes to that shared instance of hal-ml daemon (see hal_ml_server_create()).
+ *          The socket path is taken from #HAL_ML_DAEMON_SOCKET_ENV, or #HAL_ML_DAEMON_DEFAULT_SOCKET.
+ *          Such a handle needs no configure_instance, and supports invoke requests only.
  * @param[in] backend_name The name of the backend to use.
  * @param[out] handle Newly created handle is returned.
  * @return @c 0 on success. Otherwise a negative error value.
@@ -90,6 +94,72 @@ int hal_ml_param_set (hal_ml_param_h param, const char *key, void *value);
  */
 int hal_ml_create (const char *backend_name, hal_ml_h *handle);
 
+/**
+ * @brief Sets where the threads of hal-ml invoking the handle and the buffers allocated for it are placed.
+ * @since HAL_MODULE_ML 1.0
+ * @details Each thread of hal-ml applies the placement before its next invoke of the handle: its CPU affinity,
+ *          and with a NUMA node, its memory policy preferring the node. Buffers from hal_ml_request_invoke_alloc()
+ *          and the pipeline stages of the handle are bound to the node and touched before their first use.
+ *          In the isolated mode, each thread claims a CPU of the set for itself, so it is not migrated and
+ *          the threads of other placements avoid it. Isolation from other processes is up to the system,
+ *          e.g. with the isolcpus kernel parameter.
+ * @remarks The counters of hal_ml_get_placement_stats() are reset. Invokes from any thread are counted.
+ * @param[in] handle The handle of the instance.
+ * @param[in] placement The placement. NULL to release the CPUs and let the threads run anywhere again.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid, the node does not exist, or no CPU is left.
+ */
+int hal_ml_set_placement (hal_ml_h handle, const hal_ml_placement_s *placement);
+
+/**
+ * @brief Gets the counters of the invokes of the handle since its placement was set.
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] handle The handle of the instance.
+ * @param[out] stats The counters.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_get_placement_stats (hal_ml_h handle, hal_ml_placement_stats_s *stats);
+
+/**
+ * @brief Creates hal-ml instance with the available backend which runs the model fastest.
+ * @since HAL_MODULE_ML 1.0
+ * @details Each available backend is created, configured with @a prop and timed over a short series
+ *          of invokes after warm-up. The measurements are stored in the profile cache under @a model_key,
+ *          so later calls with the same key create the best backend without any benchmark invoke.
+ *          The model is measured again when a backend is installed or removed, or the chosen one fails to configure.
+ *          Nothing is stored when no backend could run the model, and a backend rejecting the model is not recorded.
+ * @remarks The @a handle should be released using hal_ml_destroy().
+ * @remarks The profile cache is "hal-ml/backend-profile.ini" in the user cache directory, or the file
+ *          given by #HAL_ML_PROFILE_CACHE_ENV. Benchmarks in a process run one at a time.
+ * @param[in] model_key The name identifying the model and @a prop in the profile cache, without '[', ']' or line breaks. NULL to measure without the cache.
+ * @param[in] prop The properties for configure_instance, given to all backends.
+ * @param[in] input The sample input of the benchmark. NULL to use zeroed tensors of hal_ml_get_tensors_layout().
+ * @param[in, out] output The output of the benchmark. NULL to allocate it from hal_ml_get_tensors_layout().
+ * @param[in] objective What to optimize.
+ * @param[out] handle Newly created handle, configured with @a prop, is returned.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid, or @a input or @a output is NULL and no backend gives the tensor layout.
+ * @retval #HAL_ML_ERROR_NOT_SUPPORTED No backend could configure and invoke the model.
+ * @retval #HAL_ML_ERROR_RUNTIME_ERROR Failed to scan the backends.
+ */
+int hal_ml_create_auto (const char *model_key, const void *prop, const void *input, void *output, hal_ml_auto_objective_e objective, hal_ml_h *handle);
+
+/**
+ * @brief Gets the library name of the backend the hal-ml instance uses.
+ * @since HAL_MODULE_ML 1.0
+ * @remarks The @a backend_name is owned by the handle and valid until it is destroyed.
+ * @param[in] handle The handle of the instance.
+ * @param[out] backend_name The library name, or #HAL_ML_DAEMON_PREFIX and the instance name for a handle of hal-ml daemon.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_get_backend_name (hal_ml_h handle, const char **backend_name);
+
 /**
  * @brief Destroys hal-ml instance
  * @since HAL_MODULE_ML 1.0
@@ -124,6 +194,126 @@ int hal_ml_request (hal_ml_h handle, const char *request_name, hal_ml_param_h pa
  */
 int hal_ml_request_invoke (hal_ml_h handle, const void *input, void *output);
 
+/**
+ * @brief Gets the sizes of the input and output tensors of the configured model.
+ * @since HAL_MODULE_ML 1.0
+ * @details The layout is queried from the backend once and cached by the handle, until the
+ *          instance is configured again or invoked with invoke_dynamic.
+ * @param[in] handle The handle of the instance.
+ * @param[out] in_layout The sizes of the input tensors. It can be NULL.
+ * @param[out] out_layout The sizes of the output tensors. It can be NULL.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_NOT_SUPPORTED The backend does not provide the tensor layout.
+ */
+int hal_ml_get_tensors_layout (hal_ml_h handle, hal_ml_tensors_layout_s *in_layout, hal_ml_tensors_layout_s *out_layout);
+
+/**
+ * @brief Allocates tensors of the given layout in one block.
+ * @since HAL_MODULE_ML 1.0
+ * @details The array of hal_ml_tensor_memory_s is terminated by an entry of NULL data, and the
+ *          data of each tensor is aligned to 64 bytes.
+ * @remarks The @a tensors should be released using hal_ml_tensors_free().
+ * @param[in] layout The sizes of the tensors.
+ * @param[out] tensors Newly allocated array of hal_ml_tensor_memory_s.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_OUT_OF_MEMORY Failed to allocate required memory.
+ */
+int hal_ml_tensors_alloc (const hal_ml_tensors_layout_s *layout, void **tensors);
+
+/**
+ * @brief Allocates tensors of the given layout in memory bound to a NUMA node.
+ * @since HAL_MODULE_ML 1.0
+ * @details Same as hal_ml_tensors_alloc(), but the pages are bound to @a numa_node and touched,
+ *          so the first invoke neither faults them in nor places them on another node.
+ * @remarks The @a tensors should be released using hal_ml_tensors_free().
+ * @param[in] layout The sizes of the tensors.
+ * @param[in] numa_node The NUMA node of the memory. -1 is the same as hal_ml_tensors_alloc().
+ * @param[out] tensors Newly allocated array of hal_ml_tensor_memory_s.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid or the node does not exist.
+ * @retval #HAL_ML_ERROR_OUT_OF_MEMORY Failed to allocate required memory.
+ */
+int hal_ml_tensors_alloc_on_node (const hal_ml_tensors_layout_s *layout, int numa_node, void **tensors);
+
+/**
+ * @brief Releases the tensors allocated by hal_ml_tensors_alloc(), hal_ml_tensors_alloc_on_node() or hal_ml_request_invoke_alloc().
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] tensors The tensors to release. It can be NULL.
+ */
+void hal_ml_tensors_free (void *tensors);
+
+/**
+ * @brief Invokes the hal-ml instance with output tensors allocated by HAL ML.
+ * @since HAL_MODULE_ML 1.0
+ * @details The output tensors are sized by the cached layout of the handle (see hal_ml_get_tensors_layout()).
+ *          To reuse the outputs over invokes, allocate them once with hal_ml_tensors_alloc() instead.
+ * @remarks The @a output should be released using hal_ml_tensors_free().
+ * @param[in] handle The handle of the instance.
+ * @param[in] input The input data for the invoke.
+ * @param[out] output Newly allocated array of hal_ml_tensor_memory_s holding the result.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_NOT_SUPPORTED The backend does not provide the tensor layout.
+ * @retval #HAL_ML_ERROR_OUT_OF_MEMORY Failed to allocate required memory.
+ */
+int hal_ml_request_invoke_alloc (hal_ml_h handle, const void *input, void **output);
+
+/**
+ * @brief Configures the hal-ml instance. Same as the request "configure_instance" without building a param.
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] handle The handle of the instance.
+ * @param[in] prop The properties of the backend.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_request_configure_instance (hal_ml_h handle, const void *prop);
+
+/**
+ * @brief Gets the framework information of the backend. Same as the request "get_framework_info".
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] handle The handle of the instance.
+ * @param[out] framework_info The framework information.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_NOT_SUPPORTED The handle is connected to hal-ml daemon.
+ */
+int hal_ml_request_get_framework_info (hal_ml_h handle, void *framework_info);
+
+/**
+ * @brief Gets or sets the model information. Same as the request "get_model_info".
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] handle The handle of the instance.
+ * @param[in] ops The operation of the backend.
+ * @param[in, out] in_info The input tensors information.
+ * @param[in, out] out_info The output tensors information.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_NOT_SUPPORTED The handle is connected to hal-ml daemon.
+ */
+int hal_ml_request_get_model_info (hal_ml_h handle, int ops, void *in_info, void *out_info);
+
+/**
+ * @brief Passes an event to the backend. Same as the request "eventHandler".
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] handle The handle of the instance.
+ * @param[in] ops The event.
+ * @param[in, out] data The data of the event.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_NOT_SUPPORTED The handle is connected to hal-ml daemon.
+ */
+int hal_ml_request_event_handler (hal_ml_h handle, int ops, void *data);
+
 /**
  * @brief Invokes the hal-ml instance dynamically with the given data.
  * @since HAL_MODULE_ML 1.0
@@ -134,9 +324,421 @@ int hal_ml_request_invoke (hal_ml_h handle, const void *input, void *output);
  * @return @c 0 on success. Otherwise a negative error value.
  * @retval #HAL_ML_ERROR_NONE Successful.
  * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_NOT_SUPPORTED The handle is connected to hal-ml daemon.
  */
 int hal_ml_request_invoke_dynamic (hal_ml_h handle, void *prop, const void *input, void *output);
 
+/**
+ * @brief Invokes the hal-ml instance with the given data, giving up after the timeout.
+ * @since HAL_MODULE_ML 1.0
+ * @details The invoke is queued to a worker thread owned by the handle. If the deadline passes
+ *          while the request is still queued, it is dropped without reaching the backend.
+ *          If the deadline passes while the backend is running it, the backend's cancel function
+ *          is called (if available) and this function returns after the backend has released
+ *          the buffers. In both cases, the content of @a output is undefined. If the backend ignores
+ *          the cancel and completes the invoke, its result is returned instead, with a valid @a output.
+ * @remarks Requests are run one by one in the order they are queued.
+ * @param[in] handle The handle of the instance.
+ * @param[in] input The input data for the invoke.
+ * @param[in, out] output The output data for the invoke.
+ * @param[in] timeout_ms The time limit in milliseconds. It should be greater than 0.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_TIMED_OUT The request did not complete within @a timeout_ms.
+ * @retval #HAL_ML_ERROR_CANCELED The request was canceled by hal_ml_request_cancel().
+ * @retval #HAL_ML_ERROR_RUNTIME_ERROR Failed to start the worker thread.
+ */
+int hal_ml_request_invoke_timeout (hal_ml_h handle, const void *input, void *output, int timeout_ms);
+
+/**
+ * @brief Cancels the invokes queued by hal_ml_request_invoke_timeout().
+ * @since HAL_MODULE_ML 1.0
+ * @details Queued requests complete with #HAL_ML_ERROR_CANCELED without reaching the backend.
+ *          The request the backend is running is canceled too if the backend supports it.
+ * @param[in] handle The handle of the instance.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_request_cancel (hal_ml_h handle);
+
+/**
+ * @brief Invokes the hal-ml instance tile by tile, for an input larger than the model.
+ * @since HAL_MODULE_ML 1.0
+ * @details The instance should be configured for one tile: a single input tensor of
+ *          outer * (tile + 2 * overlap) * in_stride bytes and a single output tensor of
+ *          outer * (tile + 2 * overlap) * out_stride bytes. The input is split along the axis of @a tiling,
+ *          each tile with its overlap is invoked, and the outputs of the tile steps are written to @a output.
+ *          A tile at an edge of the input is shifted inwards instead of padded, so every invoke sees real data.
+ *          Up to in_flight tiles are queued to the invoke worker of the handle while the calling thread copies
+ *          the next tiles in and the finished ones out. Only in_flight tile buffers are allocated,
+ *          on the NUMA node of the placement if any, however large the input is.
+ *          If outer is 1, the tiles are read from @a input without copying.
+ * @remarks The model should be spatially local along the axis: an output step should depend only on the input
+ *          steps within @a overlap of it. Otherwise the result differs from invoking the whole input.
+ * @remarks hal_ml_request_cancel() cancels the remaining tiles, even if it is called while no tile is queued.
+ * @param[in] handle The handle of the instance.
+ * @param[in] tiling The split of the tensors.
+ * @param[in] input The input data, an array of hal_ml_tensor_memory_s with one tensor of outer * length * in_stride bytes.
+ * @param[in, out] output The output data, an array of hal_ml_tensor_memory_s with one tensor of outer * length * out_stride bytes.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid, the input is shorter than a tile with its overlap,
+ *         or the tensor layout of the instance does not match a tile.
+ * @retval #HAL_ML_ERROR_CANCELED The request was canceled by hal_ml_request_cancel().
+ * @retval #HAL_ML_ERROR_OUT_OF_MEMORY Failed to allocate required memory.
+ * @retval #HAL_ML_ERROR_RUNTIME_ERROR Failed to start the worker thread.
+ */
+int hal_ml_request_invoke_tiled (hal_ml_h handle, const hal_ml_tiling_s *tiling, const void *input, void *output);
+
+/**
+ * @brief Callback to receive the result of a frame in the streaming mode.
+ * @since HAL_MODULE_ML 1.0
+ * @details This is called exactly once for each pushed frame. For a frame dropped without being
+ *          invoked, @a result is #HAL_ML_ERROR_CANCELED and @a output is NULL; in this case the callback
+ *          is called on the thread which dropped the frame (the producer, or the one stopping the stream).
+ *          The frame's input can be reused after this is called.
+ * @param[in] input The input data given to hal_ml_stream_push().
+ * @param[in] output The output data given to hal_ml_stream_start(), valid only in the callback.
+ * @param[in] result The result of the invoke.
+ * @param[in] frame_data The frame data given to hal_ml_stream_push().
+ * @param[in] user_data The user data given to hal_ml_stream_start().
+ */
+typedef void (*hal_ml_stream_cb) (const void *input, void *output, int result, void *frame_data, void *user_data);
+
+/**
+ * @brief Starts the streaming mode of hal-ml instance.
+ * @since HAL_MODULE_ML 1.0
+ * @details Frames pushed with hal_ml_stream_push() are queued in a lock-free ring with @a depth slots,
+ *          and a dedicated thread invokes them one by one. When the ring is full, @a policy decides
+ *          whether stale frames are dropped or the producer waits, which keeps the end-to-end latency
+ *          bounded when the device is slower than the source.
+ * @remarks The ring is single-producer: hal_ml_stream_push() should be called from one thread at a time.
+ * @remarks The handle should not be invoked by others while the stream is running.
+ * @param[in] handle The handle of the instance.
+ * @param[in] depth The number of frames which can wait in the ring. It should be greater than 0.
+ * @param[in] policy What to do with a new frame when the ring is full.
+ * @param[in, out] output The output data for the invokes, reused for every frame.
+ * @param[in] callback The callback for the results.
+ * @param[in] user_data The user data passed to @a callback.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid or the stream is running.
+ * @retval #HAL_ML_ERROR_RUNTIME_ERROR Failed to start the inference thread.
+ */
+int hal_ml_stream_start (hal_ml_h handle, unsigned int depth, hal_ml_stream_policy_e policy, void *output, hal_ml_stream_cb callback, void *user_data);
+
+/**
+ * @brief Pushes a frame to the streaming mode of hal-ml instance.
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] handle The handle of the instance.
+ * @param[in] input The input data for the invoke. It should be valid until the callback for the frame is called.
+ * @param[in] frame_data The data passed to the callback with the result of this frame.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful. The frame is queued; it may be dropped later.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid or the stream is not running.
+ * @retval #HAL_ML_ERROR_CANCELED The stream was stopped while waiting for room (#HAL_ML_STREAM_POLICY_BLOCK). The callback is not called for the frame.
+ */
+int hal_ml_stream_push (hal_ml_h handle, const void *input, void *frame_data);
+
+/**
+ * @brief Stops the streaming mode of hal-ml instance.
+ * @since HAL_MODULE_ML 1.0
+ * @details The frame being invoked is completed, and the frames still queued are dropped.
+ * @param[in] handle The handle of the instance.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid or the stream is not running.
+ */
+int hal_ml_stream_stop (hal_ml_h handle);
+
+/**
+ * @brief Gets the counters of the streaming mode of hal-ml instance.
+ * @since HAL_MODULE_ML 1.0
+ * @remarks The counters are kept after the stream is stopped, and reset when it is started again.
+ * @param[in] handle The handle of the instance.
+ * @param[out] stats The counters.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid or the stream was never started.
+ */
+int hal_ml_stream_get_stats (hal_ml_h handle, hal_ml_stream_stats_s *stats);
+
+/**
+ * @brief A handle for hal-ml-pipeline instance
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef void *hal_ml_pipeline_h;
+
+/**
+ * @brief Callback to convert the output of the previous stage into the input of a stage.
+ * @since HAL_MODULE_ML 1.0
+ * @remarks This is needed only if the layouts of the two stages do not match.
+ * @param[in] prev_output The output tensors of the previous stage.
+ * @param[out] input The input tensors of the stage, allocated by the pipeline.
+ * @param[in] user_data The user data given to hal_ml_pipeline_add_stage().
+ * @return @c 0 on success. Otherwise a negative error value, which drops the frame.
+ */
+typedef int (*hal_ml_pipeline_transform_cb) (const hal_ml_tensor_memory_s *prev_output, hal_ml_tensor_memory_s *input, void *user_data);
+
+/**
+ * @brief Callback to receive the result of a frame from the last stage.
+ * @since HAL_MODULE_ML 1.0
+ * @remarks The input tensors given to hal_ml_pipeline_push() for the frame can be reused after this is called.
+ * @param[in] frame_data The frame data given to hal_ml_pipeline_push().
+ * @param[in] output The output tensors of the last stage, valid only in the callback. NULL if @a result is not 0.
+ * @param[in] result @c 0 if all stages succeeded. Otherwise the error value of the stage which failed.
+ * @param[in] user_data The user data given to hal_ml_pipeline_set_result_cb().
+ */
+typedef void (*hal_ml_pipeline_result_cb) (void *frame_data, const hal_ml_tensor_memory_s *output, int result, void *user_data);
+
+/**
+ * @brief Creates hal-ml-pipeline instance, which runs several hal-ml instances in stages.
+ * @since HAL_MODULE_ML 1.0
+ * @details Each stage runs on its own thread, and the stages are linked with bounded queues.
+ *          The output buffers of a stage are handed to the next stage without copies.
+ * @remarks The @a pipeline should be released using hal_ml_pipeline_destroy().
+ * @param[in] queue_depth The maximum number of frames waiting for each stage. It should be greater than 0.
+ * @param[out] pipeline Newly created pipeline handle is returned.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_OUT_OF_MEMORY Failed to allocate required memory.
+ */
+int hal_ml_pipeline_create (unsigned int queue_depth, hal_ml_pipeline_h *pipeline);
+
+/**
+ * @brief Destroys hal-ml-pipeline instance. The pipeline is stopped if it is running.
+ * @since HAL_MODULE_ML 1.0
+ * @remarks The hal-ml instances of the stages are not destroyed.
+ * @param[in] pipeline The handle of the pipeline to be destroyed.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_pipeline_destroy (hal_ml_pipeline_h pipeline);
+
+/**
+ * @brief Appends a stage to hal-ml-pipeline instance.
+ * @since HAL_MODULE_ML 1.0
+ * @remarks The @a handle should be configured, and should not be invoked by others while the pipeline is running.
+ * @param[in] pipeline The handle of the pipeline.
+ * @param[in] handle The hal-ml instance to invoke in the stage.
+ * @param[in] in_layout The layout of the input tensors of @a handle. NULL with @a out_layout NULL to use hal_ml_get_tensors_layout().
+ * @param[in] out_layout The layout of the output tensors of @a handle.
+ * @param[in] transform Callback to fill the input from the previous stage's output. If NULL, the previous output is handed over as the input, and the layouts should match.
+ * @param[in] user_data The user data passed to @a transform.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid, the layouts do not match, or the pipeline is running.
+ * @retval #HAL_ML_ERROR_OUT_OF_MEMORY Failed to allocate required memory.
+ */
+int hal_ml_pipeline_add_stage (hal_ml_pipeline_h pipeline, hal_ml_h handle, const hal_ml_tensors_layout_s *in_layout, const hal_ml_tensors_layout_s *out_layout, hal_ml_pipeline_transform_cb transform, void *user_data);
+
+/**
+ * @brief Sets the callback to receive the results of hal-ml-pipeline instance.
+ * @since HAL_MODULE_ML 1.0
+ * @remarks The callback is called on the thread of the last stage.
+ * @param[in] pipeline The handle of the pipeline.
+ * @param[in] callback The callback for the results.
+ * @param[in] user_data The user data passed to @a callback.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid or the pipeline is running.
+ */
+int hal_ml_pipeline_set_result_cb (hal_ml_pipeline_h pipeline, hal_ml_pipeline_result_cb callback, void *user_data);
+
+/**
+ * @brief Starts the stage threads of hal-ml-pipeline instance.
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] pipeline The handle of the pipeline.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid, there is no stage or result callback, or the pipeline is running.
+ * @retval #HAL_ML_ERROR_OUT_OF_MEMORY Failed to allocate required memory.
+ * @retval #HAL_ML_ERROR_RUNTIME_ERROR Failed to start the threads.
+ */
+int hal_ml_pipeline_start (hal_ml_pipeline_h pipeline);
+
+/**
+ * @brief Stops hal-ml-pipeline instance after the frames pushed so far are processed.
+ * @since HAL_MODULE_ML 1.0
+ * @details A frame pushed while the pipeline is stopping is rejected, so every accepted frame gets its result callback.
+ *          The result callback can call hal_ml_pipeline_push() meanwhile, which fails.
+ * @remarks This should not be called from the callbacks of the pipeline.
+ * @param[in] pipeline The handle of the pipeline.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_pipeline_stop (hal_ml_pipeline_h pipeline);
+
+/**
+ * @brief Pushes a frame into hal-ml-pipeline instance.
+ * @since HAL_MODULE_ML 1.0
+ * @details This blocks while the queue of the first stage is full.
+ * @remarks The @a input is handed to the first stage without copies. It should be valid until the result callback for the frame is called.
+ * @param[in] pipeline The handle of the pipeline.
+ * @param[in] input The input tensors for the first stage.
+ * @param[in] frame_data The data passed to the result callback with the result of this frame.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid or the pipeline is not running or stopping.
+ */
+int hal_ml_pipeline_push (hal_ml_pipeline_h pipeline, const hal_ml_tensor_memory_s *input, void *frame_data);
+
+/**
+ * @brief A handle for hal-ml-mux instance
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef void *hal_ml_mux_h;
+
+/**
+ * @brief Creates hal-ml-mux instance, which multiplexes many models on one backend.
+ * @since HAL_MODULE_ML 1.0
+ * @details The mux keeps the recently used models configured (resident) within the budget,
+ *          and loads a model on demand by evicting the least recently used ones.
+ * @remarks The @a mux should be released using hal_ml_mux_destroy().
+ * @param[in] backend_name The name of the backend to use for all models.
+ * @param[in] max_instances The maximum number of resident models. It should be greater than 0.
+ * @param[in] memory_budget The maximum sum of the memory costs of the resident models in bytes. 0 means no limit.
+ * @param[out] mux Newly created mux handle is returned.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_RUNTIME_ERROR Failed to start the prefetch thread.
+ */
+int hal_ml_mux_create (const char *backend_name, unsigned int max_instances, size_t memory_budget, hal_ml_mux_h *mux);
+
+/**
+ * @brief Destroys hal-ml-mux instance and the hal-ml instances of its resident models.
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] mux The handle of the mux to be destroyed.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_mux_destroy (hal_ml_mux_h mux);
+
+/**
+ * @brief Registers a model to hal-ml-mux instance. The model is loaded when it is requested.
+ * @since HAL_MODULE_ML 1.0
+ * @remarks The @a prop should be valid until the mux is destroyed.
+ * @param[in] mux The handle of the mux.
+ * @param[in] model_id The name to identify the model.
+ * @param[in] prop The properties for configure_instance of the model.
+ * @param[in] memory_cost The device memory the model takes when resident, in bytes.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid, the model is already registered, or it exceeds the budget.
+ */
+int hal_ml_mux_add_model (hal_ml_mux_h mux, const char *model_id, const void *prop, size_t memory_cost);
+
+/**
+ * @brief Enables or disables preloading the model which is likely requested next.
+ * @since HAL_MODULE_ML 1.0
+ * @details The mux learns which model usually follows each model from the observed requests,
+ *          and loads it on a background thread after an invoke, if that does not evict a model in use.
+ * @param[in] mux The handle of the mux.
+ * @param[in] enable True to enable prefetch. It is disabled by default.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_mux_set_prefetch (hal_ml_mux_h mux, bool enable);
+
+/**
+ * @brief Invokes a model of hal-ml-mux instance, loading it if it is not resident.
+ * @since HAL_MODULE_ML 1.0
+ * @remarks Invokes of the same model are serialized. This blocks while all resident models are in use and there is no room.
+ * @param[in] mux The handle of the mux.
+ * @param[in] model_id The name of the model given to hal_ml_mux_add_model().
+ * @param[in] input The input data for the invoke.
+ * @param[in, out] output The output data for the invoke.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid or the model is not registered.
+ */
+int hal_ml_mux_invoke (hal_ml_mux_h mux, const char *model_id, const void *input, void *output);
+
+/**
+ * @brief Gets the counters of hal-ml-mux instance.
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] mux The handle of the mux.
+ * @param[out] stats The counters.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_mux_get_stats (hal_ml_mux_h mux, hal_ml_mux_stats_s *stats);
+
+/**
+ * @brief Gets the tensors shared with hal-ml daemon, for a handle created with #HAL_ML_DAEMON_PREFIX.
+ * @since HAL_MODULE_ML 1.0
+ * @details The tensors are in memory mapped by both the daemon and this process. Invoking with them
+ *          passes no tensor data over the socket, while other buffers are copied into and out of them.
+ *          Each array is terminated by an entry of NULL data.
+ * @remarks The arrays are owned by the handle and valid until it is destroyed.
+ * @param[in] handle The handle connected to hal-ml daemon.
+ * @param[out] input The array of hal_ml_tensor_memory_s for the input.
+ * @param[out] output The array of hal_ml_tensor_memory_s for the output.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ * @retval #HAL_ML_ERROR_NOT_SUPPORTED The handle is not connected to hal-ml daemon.
+ */
+int hal_ml_get_shared_tensors (hal_ml_h handle, void **input, void **output);
+
+/**
+ * @brief Handle of hal-ml daemon, which shares configured instances with other processes.
+ * @since HAL_MODULE_ML 1.0
+ */
+typedef void *hal_ml_server_h;
+
+/**
+ * @brief Starts hal-ml daemon listening on a Unix socket.
+ * @since HAL_MODULE_ML 1.0
+ * @details The process calling this owns the backend instances added with hal_ml_server_add_instance().
+ *          Other processes use them with hal_ml_create() and #HAL_ML_DAEMON_PREFIX.
+ * @remarks The @a server should be released using hal_ml_server_destroy(). An existing socket at @a socket_path is replaced,
+ *          but any other file there is kept and makes this fail.
+ * @remarks The socket is created with mode 0600, and only clients of the same user or root are accepted.
+ * @param[in] socket_path The path of the socket to listen on.
+ * @param[out] server Newly created server handle is returned.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid, or @a socket_path is a file which is not a socket.
+ * @retval #HAL_ML_ERROR_RUNTIME_ERROR Failed to listen on the socket.
+ */
+int hal_ml_server_create (const char *socket_path, hal_ml_server_h *server);
+
+/**
+ * @brief Creates and configures a backend instance shared with the clients of hal-ml daemon.
+ * @since HAL_MODULE_ML 1.0
+ * @details Invokes from all clients of the instance are serialized.
+ * @param[in] server The handle of the server.
+ * @param[in] name The instance name the clients give to hal_ml_create() after #HAL_ML_DAEMON_PREFIX.
+ * @param[in] backend_name The name of the backend to use.
+ * @param[in] prop The properties for configure_instance.
+ * @param[in] in_layout The sizes of the input tensors. NULL with @a out_layout NULL to use hal_ml_get_tensors_layout().
+ * @param[in] out_layout The sizes of the output tensors.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid or the name is already used.
+ */
+int hal_ml_server_add_instance (hal_ml_server_h server, const char *name, const char *backend_name, const void *prop, const hal_ml_tensors_layout_s *in_layout, const hal_ml_tensors_layout_s *out_layout);
+
+/**
+ * @brief Stops hal-ml daemon, disconnecting its clients and destroying its instances.
+ * @since HAL_MODULE_ML 1.0
+ * @param[in] server The handle of the server to be destroyed.
+ * @return @c 0 on success. Otherwise a negative error value.
+ * @retval #HAL_ML_ERROR_NONE Successful.
+ * @retval #HAL_ML_ERROR_INVALID_PARAMETER Fail. The parameter is invalid.
+ */
+int hal_ml_server_destroy (hal_ml_server_h server);
+
 /**
  * @}
  */
@@ -0,0 +1,362 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - C++ wrapper
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-ml.hpp
+ * @date    18 Oct 2026
+ * @brief   Header-only C++ wrapper of HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * Handle and Param own the C handles and release them when they go out of
+ * scope. They are move-only, so a handle can be returned or stored without
+ * being destroyed twice. Typed requests call the request functions of
+ * hal-ml.h directly: no param table, no request name lookup and no heap
+ * allocation. As in the C API, the functions return hal_ml_error_e values
+ * and do not throw.
+ */
+
+#ifndef __HAL_ML_HPP__
+#define __HAL_ML_HPP__
+
+#include <cstddef>
+#include <utility>
+
+#include "hal-ml.h"
+
+namespace hal
+{
+namespace ml
+{
+
+/**
+ * @brief The requests of a hal-ml instance.
+ */
+enum class Op {
+  ConfigureInstance,
+  Invoke,
+  InvokeDynamic,
+  GetFrameworkInfo,
+  GetModelInfo,
+  EventHandler,
+};
+
+namespace detail
+{
+/**
+ * @brief Maps a request to its C function. The parameter types of call () are checked at compile time.
+ */
+template <Op op> struct request_traits;
+
+template <> struct request_traits<Op::ConfigureInstance> {
+  static int call (hal_ml_h h, const void *prop) noexcept
+  {
+    return hal_ml_request_configure_instance (h, prop);
+  }
+};
+
+template <> struct request_traits<Op::Invoke> {
+  static int call (hal_ml_h h, const void *input, void *output) noexcept
+  {
+    return hal_ml_request_invoke (h, input, output);
+  }
+};
+
+template <> struct request_traits<Op::InvokeDynamic> {
+  static int call (hal_ml_h h, void *prop, const void *input, void *output) noexcept
+  {
+    return hal_ml_request_invoke_dynamic (h, prop, input, output);
+  }
+};
+
+template <> struct request_traits<Op::GetFrameworkInfo> {
+  static int call (hal_ml_h h, void *framework_info) noexcept
+  {
+    return hal_ml_request_get_framework_info (h, framework_info);
+  }
+};
+
+template <> struct request_traits<Op::GetModelInfo> {
+  static int call (hal_ml_h h, int ops, void *in_info, void *out_info) noexcept
+  {
+    return hal_ml_request_get_model_info (h, ops, in_info, out_info);
+  }
+};
+
+template <> struct request_traits<Op::EventHandler> {
+  static int call (hal_ml_h h, int ops, void *data) noexcept
+  {
+    return hal_ml_request_event_handler (h, ops, data);
+  }
+};
+} /* namespace detail */
+
+/**
+ * @brief Fixed-size array of N tensor memories, terminated by an empty entry.
+ * @details It only refers to the buffers, so it can live on the stack and be reused for every invoke.
+ */
+template <std::size_t N> class Tensors
+{
+  static_assert (N > 0 && N <= HAL_ML_TENSOR_SIZE_LIMIT, "Invalid number of tensors");
+
+  public:
+  void set (std::size_t index, void *data, std::size_t size) noexcept
+  {
+    mem_[index].data = data;
+    mem_[index].size = size;
+  }
+
+  hal_ml_tensor_memory_s &operator[] (std::size_t index) noexcept
+  {
+    return mem_[index];
+  }
+
+  const hal_ml_tensor_memory_s &operator[] (std::size_t index) const noexcept
+  {
+    return mem_[index];
+  }
+
+  hal_ml_tensor_memory_s *data () noexcept
+  {
+    return mem_;
+  }
+
+  const hal_ml_tensor_memory_s *data () const noexcept
+  {
+    return mem_;
+  }
+
+  static constexpr std::size_t size () noexcept
+  {
+    return N;
+  }
+
+  private:
+  hal_ml_tensor_memory_s mem_[N + 1] = {};
+};
+
+/**
+ * @brief Owner of hal_ml_param_h, for the requests by name.
+ */
+class Param
+{
+  public:
+  Param () noexcept = default;
+
+  ~Param ()
+  {
+    reset ();
+  }
+
+  Param (Param &&other) noexcept : param_ (other.release ())
+  {
+  }
+
+  Param &operator= (Param &&other) noexcept
+  {
+    if (this != &other)
+      reset (other.release ());
+    return *this;
+  }
+
+  Param (const Param &) = delete;
+  Param &operator= (const Param &) = delete;
+
+  static int create (Param &param) noexcept
+  {
+    hal_ml_param_h p = nullptr;
+    int ret = hal_ml_param_create (&p);
+
+    if (ret == HAL_ML_ERROR_NONE)
+      param.reset (p);
+    return ret;
+  }
+
+  int set (const char *key, void *value) noexcept
+  {
+    return hal_ml_param_set (param_, key, value);
+  }
+
+  hal_ml_param_h get () const noexcept
+  {
+    return param_;
+  }
+
+  explicit operator bool () const noexcept
+  {
+    return param_ != nullptr;
+  }
+
+  hal_ml_param_h release () noexcept
+  {
+    hal_ml_param_h p = param_;
+    param_ = nullptr;
+    return p;
+  }
+
+  void reset (hal_ml_param_h p = nullptr) noexcept
+  {
+    if (param_)
+      hal_ml_param_destroy (param_);
+    param_ = p;
+  }
+
+  private:
+  hal_ml_param_h param_ = nullptr;
+};
+
+/**
+ * @brief Owner of hal_ml_h.
+ */
+class Handle
+{
+  public:
+  Handle () noexcept = default;
+
+  /**
+   * @brief Takes the ownership of @a handle.
+   */
+  explicit Handle (hal_ml_h handle) noexcept : handle_ (handle)
+  {
+  }
+
+  ~Handle ()
+  {
+    reset ();
+  }
+
+  Handle (Handle &&other) noexcept : handle_ (other.release ())
+  {
+  }
+
+  Handle &operator= (Handle &&other) noexcept
+  {
+    if (this != &other)
+      reset (other.release ());
+    return *this;
+  }
+
+  Handle (const Handle &) = delete;
+  Handle &operator= (const Handle &) = delete;
+
+  /**
+   * @brief Creates a hal-ml instance. See hal_ml_create().
+   */
+  static int create (const char *backend_name, Handle &handle) noexcept
+  {
+    hal_ml_h h = nullptr;
+    int ret = hal_ml_create (backend_name, &h);
+
+    if (ret == HAL_ML_ERROR_NONE)
+      handle.reset (h);
+    return ret;
+  }
+
+  /**
+   * @brief Calls the request @a op. The arguments should match its C function.
+   */
+  template <Op op, typename... Args> int request (Args &&...args) noexcept
+  {
+    return detail::request_traits<op>::call (handle_, std::forward<Args> (args)...);
+  }
+
+  /**
+   * @brief Calls a request by name. See hal_ml_request().
+   */
+  int request (const char *request_name, Param &param) noexcept
+  {
+    return hal_ml_request (handle_, request_name, param.get ());
+  }
+
+  int configure (const void *prop) noexcept
+  {
+    return request<Op::ConfigureInstance> (prop);
+  }
+
+  template <typename In, typename Out> int invoke (const In *input, Out *output) noexcept
+  {
+    return request<Op::Invoke> (static_cast<const void *> (input), static_cast<void *> (output));
+  }
+
+  template <std::size_t N, std::size_t M>
+  int invoke (const Tensors<N> &input, Tensors<M> &output) noexcept
+  {
+    return invoke (input.data (), output.data ());
+  }
+
+  template <std::size_t N, std::size_t M>
+  int invoke_timeout (const Tensors<N> &input, Tensors<M> &output, int timeout_ms) noexcept
+  {
+    return hal_ml_request_invoke_timeout (handle_, input.data (), output.data (), timeout_ms);
+  }
+
+  /**
+   * @brief Invokes the instance tile by tile. See hal_ml_request_invoke_tiled().
+   */
+  int invoke_tiled (const hal_ml_tiling_s &tiling, const Tensors<1> &input, Tensors<1> &output) noexcept
+  {
+    return hal_ml_request_invoke_tiled (handle_, &tiling, input.data (), output.data ());
+  }
+
+  /**
+   * @brief Gets the cached tensor layouts. See hal_ml_get_tensors_layout().
+   */
+  int tensors_layout (hal_ml_tensors_layout_s *in_layout, hal_ml_tensors_layout_s *out_layout) noexcept
+  {
+    return hal_ml_get_tensors_layout (handle_, in_layout, out_layout);
+  }
+
+  /**
+   * @brief Sets the placement of the threads and buffers of the handle. See hal_ml_set_placement().
+   */
+  int set_placement (const hal_ml_placement_s *placement) noexcept
+  {
+    return hal_ml_set_placement (handle_, placement);
+  }
+
+  int placement_stats (hal_ml_placement_stats_s &stats) noexcept
+  {
+    return hal_ml_get_placement_stats (handle_, &stats);
+  }
+
+  int cancel () noexcept
+  {
+    return hal_ml_request_cancel (handle_);
+  }
+
+  hal_ml_h get () const noexcept
+  {
+    return handle_;
+  }
+
+  explicit operator bool () const noexcept
+  {
+    return handle_ != nullptr;
+  }
+
+  hal_ml_h release () noexcept
+  {
+    hal_ml_h h = handle_;
+    handle_ = nullptr;
+    return h;
+  }
+
+  void reset (hal_ml_h h = nullptr) noexcept
+  {
+    if (handle_)
+      hal_ml_destroy (handle_);
+    handle_ = h;
+  }
+
+  private:
+  hal_ml_h handle_ = nullptr;
+};
+
+} /* namespace ml */
+} /* namespace hal */
+
+#endif /* __HAL_ML_HPP__ */
@@ -52,6 +52,7 @@ make %{?jobs:-j%jobs}
 
 %check
 LD_LIBRARY_PATH=./ ./ml-haltests
+LD_LIBRARY_PATH=./ ./ml-haltests-loopback
 
 %install
 rm -rf %{buildroot}
@@ -86,6 +87,7 @@ rm -rf %{buildroot}
 %defattr(-,root,root,-)
 %manifest hal-api-ml.manifest
 %{_bindir}/hal/ml-haltests
+%{_bindir}/hal/ml-haltests-loopback
 
 %changelog
 * Wed Aug 27 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
@@ -0,0 +1,399 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - automatic backend selection
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-auto.c
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - automatic backend selection
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * hal_ml_create_auto () configures the model on every available backend and
+ * times its invokes: a few warm-up invokes (the first one often compiles the
+ * model) are discarded, then invokes are timed until the time budget is spent.
+ * Both the median and the mean time of each backend are kept in a key file,
+ * one group per model key and one key per backend library, so either
+ * objective is answered from the cache later. The group also lists the
+ * backends measured, so the model is measured again when the set changes.
+ *
+ * A backend whose invoke failed is stored with negative times and is not
+ * tried again until the model is measured again. A backend which rejected
+ * the model or the benchmark tensors (NOT_SUPPORTED or INVALID_PARAMETER) is
+ * not stored at all. Nothing is stored when no backend could run the model,
+ * so a bad property or a transient failure does not stick to the model key.
+ *
+ * The cache lock is held only to read or write the key file. The benchmarks
+ * are serialized by a lock of their own, so they do not disturb each other's
+ * measurements, while a model found in the cache never waits for them.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal-api-ml-private.h"
+
+#define HAL_ML_AUTO_WARMUP (2)
+#define HAL_ML_AUTO_MIN_ITERATIONS (5)
+#define HAL_ML_AUTO_MAX_ITERATIONS (100)
+#define HAL_ML_AUTO_BUDGET_US (50 * G_TIME_SPAN_MILLISECOND)
+#define HAL_ML_AUTO_FAILED (-1.0)
+#define HAL_ML_AUTO_SKIPPED (-2.0) /* never stored */
+#define HAL_ML_AUTO_BACKENDS_KEY "backends"
+
+#define HAL_ML_AUTO_CACHE_DIR "hal-ml"
+#define HAL_ML_AUTO_CACHE_FILE "backend-profile.ini"
+
+/* Serializes the accesses to the profile cache file. */
+G_LOCK_DEFINE_STATIC (hal_ml_auto_cache_lock);
+/* Only one benchmark runs at a time, so benchmarks do not disturb each other's measurements. */
+G_LOCK_DEFINE_STATIC (hal_ml_auto_bench_lock);
+
+typedef struct _hal_ml_auto_score_s {
+  gdouble median_us;
+  gdouble mean_us;
+} hal_ml_auto_score_s;
+
+static gboolean
+hal_ml_auto_key_is_valid (const char *model_key)
+{
+  return model_key[0] != '\0' && !strpbrk (model_key, "[]\r\n");
+}
+
+static gdouble
+hal_ml_auto_cost (const hal_ml_auto_score_s *score, hal_ml_auto_objective_e objective)
+{
+  return (objective == HAL_ML_AUTO_OBJECTIVE_LATENCY) ? score->median_us : score->mean_us;
+}
+
+static gchar *
+hal_ml_auto_cache_path (void)
+{
+  const gchar *path = g_getenv (HAL_ML_PROFILE_CACHE_ENV);
+
+  if (path)
+    return g_strdup (path);
+
+  return g_build_filename (g_get_user_cache_dir (), HAL_ML_AUTO_CACHE_DIR, HAL_ML_AUTO_CACHE_FILE, NULL);
+}
+
+static void
+hal_ml_auto_cache_save (GKeyFile *cache, const gchar *path)
+{
+  gchar *dir = g_path_get_dirname (path);
+  GError *error = NULL;
+
+  /* The profile only saves time later, so a read-only cache is not an error. */
+  if (g_mkdir_with_parents (dir, 0755) != 0 || !g_key_file_save_to_file (cache, path, &error))
+    _W ("Failed to save the backend profile to %s: %s", path, error ? error->message : "no directory");
+
+  g_clear_error (&error);
+  g_free (dir);
+}
+
+/**
+ * @brief Finds the best backend in the profile cache. Returns NULL if the model is not measured with these backends.
+ */
+static const gchar *
+hal_ml_auto_cache_lookup (GKeyFile *cache, const char *model_key, gchar **names, int count,
+    hal_ml_auto_objective_e objective)
+{
+  const gchar *best = NULL;
+  gdouble best_cost = 0;
+  gsize num_measured = 0;
+  gchar **measured;
+  gboolean same_set;
+
+  /* A profile of another set of backends, e.g. before one is installed or removed, is measured again. */
+  measured = g_key_file_get_string_list (cache, model_key, HAL_ML_AUTO_BACKENDS_KEY, &num_measured, NULL);
+  same_set = (measured && num_measured == (gsize) count);
+  for (int i = 0; same_set && i < count; i++)
+    same_set = g_strv_contains ((const gchar * const *) measured, names[i]);
+  g_strfreev (measured);
+
+  if (!same_set) {
+    _I ("The backends are not profiled for %s yet.", model_key);
+    return NULL;
+  }
+
+  for (int i = 0; i < count; i++) {
+    gsize length = 0;
+    gdouble *times = g_key_file_get_double_list (cache, model_key, names[i], &length, NULL);
+    hal_ml_auto_score_s score;
+
+    /* A backend which rejected the model is not stored. */
+    if (!times || length != 2) {
+      g_free (times);
+      continue;
+    }
+
+    score.median_us = times[0];
+    score.mean_us = times[1];
+    g_free (times);
+
+    if (hal_ml_auto_cost (&score, objective) >= 0
+        && (!best || hal_ml_auto_cost (&score, objective) < best_cost)) {
+      best = names[i];
+      best_cost = hal_ml_auto_cost (&score, objective);
+    }
+  }
+
+  return best;
+}
+
+/**
+ * @brief Stores the scores of a model in the profile cache, unless no backend could run it.
+ */
+static void
+hal_ml_auto_cache_store (const gchar *path, const char *model_key, gchar **names, int count,
+    const hal_ml_auto_score_s *scores)
+{
+  GKeyFile *cache;
+  gboolean measured = FALSE;
+
+  for (int i = 0; i < count; i++)
+    measured |= (scores[i].median_us >= 0);
+
+  /* Keep the previous profile, as the failure may be of this call only, e.g. a bad property. */
+  if (!measured)
+    return;
+
+  cache = g_key_file_new ();
+
+  G_LOCK (hal_ml_auto_cache_lock);
+  /* Load again, as other models may have been stored since the lookup. */
+  g_key_file_load_from_file (cache, path, G_KEY_FILE_NONE, NULL);
+  g_key_file_remove_group (cache, model_key, NULL);
+
+  g_key_file_set_string_list (cache, model_key, HAL_ML_AUTO_BACKENDS_KEY,
+      (const gchar * const *) names, (gsize) count);
+  for (int i = 0; i < count; i++) {
+    gdouble times[2] = { scores[i].median_us, scores[i].mean_us };
+
+    if (scores[i].median_us != HAL_ML_AUTO_SKIPPED)
+      g_key_file_set_double_list (cache, model_key, names[i], times, 2);
+  }
+
+  hal_ml_auto_cache_save (cache, path);
+  G_UNLOCK (hal_ml_auto_cache_lock);
+
+  g_key_file_free (cache);
+}
+
+static int
+hal_ml_auto_open (const gchar *backend_lib_name, const void *prop, hal_ml_h *handle)
+{
+  hal_ml_h ml;
+  int ret;
+
+  ret = hal_ml_create_with_library (backend_lib_name, &ml);
+  if (ret != HAL_ML_ERROR_NONE)
+    return ret;
+
+  ret = hal_ml_request_configure_instance (ml, prop);
+  if (ret != HAL_ML_ERROR_NONE) {
+    hal_ml_destroy (ml);
+    return ret;
+  }
+
+  *handle = ml;
+  return HAL_ML_ERROR_NONE;
+}
+
+static int
+hal_ml_auto_compare_time (const void *a, const void *b)
+{
+  gint64 ta = *(const gint64 *) a;
+  gint64 tb = *(const gint64 *) b;
+
+  return (ta > tb) - (ta < tb);
+}
+
+/**
+ * @brief Times the invokes of @a ml after warm-up.
+ */
+static int
+hal_ml_auto_measure (hal_ml_h ml, const void *input, void *output, hal_ml_auto_score_s *score)
+{
+  hal_ml_tensors_layout_s in_layout, out_layout;
+  void *in_tensors = NULL, *out_tensors = NULL;
+  gint64 times[HAL_ML_AUTO_MAX_ITERATIONS];
+  gint64 start, total = 0;
+  guint n;
+  int ret = HAL_ML_ERROR_NONE;
+
+  if (!input || !output) {
+    ret = hal_ml_get_tensors_layout (ml, &in_layout, &out_layout);
+    if (ret == HAL_ML_ERROR_NOT_SUPPORTED) {
+      _E ("The benchmark needs sample tensors, as the backend does not provide the tensor layout.");
+      ret = HAL_ML_ERROR_INVALID_PARAMETER;
+    }
+    if (ret == HAL_ML_ERROR_NONE && !input) {
+      ret = hal_ml_tensors_alloc (&in_layout, &in_tensors);
+      for (guint i = 0; ret == HAL_ML_ERROR_NONE && i < in_layout.num_tensors; i++) {
+        hal_ml_tensor_memory_s *mem = (hal_ml_tensor_memory_s *) in_tensors;
+
+        memset (mem[i].data, 0, mem[i].size);
+      }
+      input = in_tensors;
+    }
+    if (ret == HAL_ML_ERROR_NONE && !output) {
+      ret = hal_ml_tensors_alloc (&out_layout, &out_tensors);
+      output = out_tensors;
+    }
+    if (ret != HAL_ML_ERROR_NONE)
+      goto done;
+  }
+
+  for (n = 0; n < HAL_ML_AUTO_WARMUP; n++) {
+    ret = hal_ml_request_invoke (ml, input, output);
+    if (ret != HAL_ML_ERROR_NONE)
+      goto done;
+  }
+
+  start = g_get_monotonic_time ();
+  for (n = 0; n < HAL_ML_AUTO_MAX_ITERATIONS; n++) {
+    gint64 begin = g_get_monotonic_time ();
+
+    if (n >= HAL_ML_AUTO_MIN_ITERATIONS && begin - start >= HAL_ML_AUTO_BUDGET_US)
+      break;
+
+    ret = hal_ml_request_invoke (ml, input, output);
+    if (ret != HAL_ML_ERROR_NONE)
+      goto done;
+
+    times[n] = g_get_monotonic_time () - begin;
+    total += times[n];
+  }
+
+  qsort (times, n, sizeof (times[0]), hal_ml_auto_compare_time);
+  score->median_us = (gdouble) times[n / 2];
+  score->mean_us = (gdouble) total / n;
+
+done:
+  hal_ml_tensors_free (in_tensors);
+  hal_ml_tensors_free (out_tensors);
+  return ret;
+}
+
+/**
+ * @brief Measures all backends into @a scores and keeps the best one configured.
+ */
+static int
+hal_ml_auto_benchmark (gchar **names, int count, const void *prop, const void *input, void *output,
+    hal_ml_auto_objective_e objective, hal_ml_auto_score_s *scores, hal_ml_h *handle)
+{
+  hal_ml_h best = NULL;
+  gdouble best_cost = 0;
+  gboolean rejected = FALSE;
+
+  G_LOCK (hal_ml_auto_bench_lock);
+  for (int i = 0; i < count; i++) {
+    hal_ml_auto_score_s *score = &scores[i];
+    hal_ml_h ml = NULL;
+    int ret;
+
+    ret = hal_ml_auto_open (names[i], prop, &ml);
+    if (ret == HAL_ML_ERROR_NONE)
+      ret = hal_ml_auto_measure (ml, input, output, score);
+
+    if (ret == HAL_ML_ERROR_NOT_SUPPORTED || ret == HAL_ML_ERROR_INVALID_PARAMETER) {
+      /* The model or the tensors do not suit the backend; this says nothing about its speed. */
+      _W ("Backend %s rejected the model (%d).", names[i], ret);
+      score->median_us = score->mean_us = HAL_ML_AUTO_SKIPPED;
+      rejected |= (ret == HAL_ML_ERROR_INVALID_PARAMETER);
+    } else if (ret != HAL_ML_ERROR_NONE) {
+      _W ("Backend %s cannot run the model (%d).", names[i], ret);
+      score->median_us = score->mean_us = HAL_ML_AUTO_FAILED;
+    } else {
+      _I ("Backend %s: median %.1f us, mean %.1f us", names[i], score->median_us, score->mean_us);
+    }
+
+    if (ret != HAL_ML_ERROR_NONE) {
+      if (ml)
+        hal_ml_destroy (ml);
+      continue;
+    }
+
+    /* Keep only the best instance, so the device holds at most two models meanwhile. */
+    if (!best || hal_ml_auto_cost (score, objective) < best_cost) {
+      if (best)
+        hal_ml_destroy (best);
+      best = ml;
+      best_cost = hal_ml_auto_cost (score, objective);
+    } else {
+      hal_ml_destroy (ml);
+    }
+  }
+  G_UNLOCK (hal_ml_auto_bench_lock);
+
+  if (!best) {
+    _E ("No backend can run the model.");
+    return rejected ? HAL_ML_ERROR_INVALID_PARAMETER : HAL_ML_ERROR_NOT_SUPPORTED;
+  }
+
+  *handle = best;
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_create_auto (const char *model_key, const void *prop, const void *input, void *output,
+    hal_ml_auto_objective_e objective, hal_ml_h *handle)
+{
+  hal_ml_auto_score_s *scores;
+  gchar *path = NULL;
+  gchar **names;
+  int count;
+  int ret;
+
+  if (!prop || !handle || (model_key && !hal_ml_auto_key_is_valid (model_key))
+      || (objective != HAL_ML_AUTO_OBJECTIVE_LATENCY && objective != HAL_ML_AUTO_OBJECTIVE_THROUGHPUT)) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  count = hal_ml_get_backend_library_names (&names);
+  if (count < 0)
+    return count;
+
+  if (count == 0) {
+    _E ("There is no available backends");
+    return HAL_ML_ERROR_NOT_SUPPORTED;
+  }
+
+  if (model_key) {
+    GKeyFile *cache = g_key_file_new ();
+    const gchar *cached;
+
+    path = hal_ml_auto_cache_path ();
+
+    G_LOCK (hal_ml_auto_cache_lock);
+    /* A missing or broken cache is measured again. */
+    g_key_file_load_from_file (cache, path, G_KEY_FILE_NONE, NULL);
+    cached = hal_ml_auto_cache_lookup (cache, model_key, names, count, objective);
+    G_UNLOCK (hal_ml_auto_cache_lock);
+    g_key_file_free (cache);
+
+    if (cached) {
+      ret = hal_ml_auto_open (cached, prop, handle);
+      if (ret == HAL_ML_ERROR_NONE) {
+        _I ("Backend %s chosen for %s from the profile cache.", cached, model_key);
+        g_free (path);
+        return HAL_ML_ERROR_NONE;
+      }
+      _W ("Profiled backend %s failed for %s, measuring again.", cached, model_key);
+    }
+  }
+
+  scores = g_new (hal_ml_auto_score_s, count);
+  ret = hal_ml_auto_benchmark (names, count, prop, input, output, objective, scores, handle);
+  if (model_key)
+    hal_ml_auto_cache_store (path, model_key, names, count, scores);
+
+  g_free (scores);
+  g_free (path);
+  return ret;
+}
@@ -0,0 +1,231 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - daemon client
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-client.c
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - daemon client
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * A handle created with "daemon:<instance>" forwards its invokes to the
+ * shared instance of hal-ml daemon. Tensors are passed in a memfd mapped by
+ * both processes. Callers filling the tensors from hal_ml_get_shared_tensors()
+ * pay no copy; other buffers are copied in and out of the shared memory.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "hal-api-ml-ipc.h"
+
+struct _hal_ml_client_s {
+  GMutex lock; /* the shared tensors are used by one invoke at a time */
+  int sock;
+  gpointer shm;
+  gsize shm_size;
+  hal_ml_tensors_layout_s in_layout;
+  hal_ml_tensors_layout_s out_layout;
+  hal_ml_tensor_memory_s input[HAL_ML_TENSOR_SIZE_LIMIT + 1];
+  hal_ml_tensor_memory_s output[HAL_ML_TENSOR_SIZE_LIMIT + 1];
+};
+
+static int
+hal_ml_client_open_socket (void)
+{
+  const gchar *path = g_getenv (HAL_ML_DAEMON_SOCKET_ENV);
+  struct sockaddr_un addr = { 0 };
+  int sock;
+
+  if (!path)
+    path = HAL_ML_DAEMON_DEFAULT_SOCKET;
+
+  if (strlen (path) >= sizeof (addr.sun_path)) {
+    _E ("The socket path %s is too long.", path);
+    return -1;
+  }
+
+  addr.sun_family = AF_UNIX;
+  g_strlcpy (addr.sun_path, path, sizeof (addr.sun_path));
+
+  sock = socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (sock < 0) {
+    _E ("Failed to create a socket.");
+    return -1;
+  }
+
+  if (connect (sock, (struct sockaddr *) &addr, sizeof (addr)) < 0) {
+    _E ("Failed to connect to hal-ml daemon at %s.", path);
+    close (sock);
+    return -1;
+  }
+
+  return sock;
+}
+
+int
+hal_ml_client_connect (const char *instance_name, hal_ml_client_s **client)
+{
+  hal_ml_client_s *c;
+  hal_ml_ipc_header_s header;
+  hal_ml_ipc_create_reply_s reply;
+  struct stat st;
+  int fd = -1;
+  int ret;
+
+  c = g_new0 (hal_ml_client_s, 1);
+  g_mutex_init (&c->lock);
+  c->sock = hal_ml_client_open_socket ();
+  if (c->sock < 0) {
+    ret = HAL_ML_ERROR_RUNTIME_ERROR;
+    goto error;
+  }
+
+  ret = hal_ml_ipc_send (c->sock, HAL_ML_IPC_CREATE, HAL_ML_ERROR_NONE,
+      instance_name, strlen (instance_name) + 1, -1);
+  if (ret == HAL_ML_ERROR_NONE)
+    ret = hal_ml_ipc_recv (c->sock, &header, &reply, sizeof (reply), &fd);
+  if (ret != HAL_ML_ERROR_NONE) {
+    _E ("Failed to talk to hal-ml daemon.");
+    goto error;
+  }
+
+  if (header.result != HAL_ML_ERROR_NONE) {
+    _E ("hal-ml daemon refused instance %s (%d).", instance_name, header.result);
+    ret = header.result;
+    goto error;
+  }
+
+  if (header.cmd != HAL_ML_IPC_CREATE || header.size != sizeof (reply) || fd < 0
+      || !hal_ml_layout_is_valid (&reply.in_layout) || !hal_ml_layout_is_valid (&reply.out_layout)
+      || reply.shm_size != hal_ml_ipc_shm_size (&reply.in_layout, &reply.out_layout)
+      || fstat (fd, &st) < 0 || (guint64) st.st_size < reply.shm_size) {
+    _E ("Got an invalid reply from hal-ml daemon.");
+    ret = HAL_ML_ERROR_RUNTIME_ERROR;
+    goto error;
+  }
+
+  c->shm = mmap (NULL, reply.shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (c->shm == MAP_FAILED) {
+    _E ("Failed to map the shared tensors.");
+    c->shm = NULL;
+    ret = HAL_ML_ERROR_RUNTIME_ERROR;
+    goto error;
+  }
+  close (fd);
+
+  c->shm_size = reply.shm_size;
+  c->in_layout = reply.in_layout;
+  c->out_layout = reply.out_layout;
+  hal_ml_ipc_map_tensors (c->shm, &c->in_layout, &c->out_layout, c->input, c->output);
+
+  *client = c;
+  return HAL_ML_ERROR_NONE;
+
+error:
+  if (fd >= 0)
+    close (fd);
+  hal_ml_client_disconnect (c);
+  return ret;
+}
+
+void
+hal_ml_client_disconnect (hal_ml_client_s *client)
+{
+  /* The daemon releases this client when the socket is closed. */
+  if (client->sock >= 0)
+    close (client->sock);
+  if (client->shm)
+    munmap (client->shm, client->shm_size);
+  g_mutex_clear (&client->lock);
+  g_free (client);
+}
+
+static gboolean
+hal_ml_client_check_tensors (const hal_ml_tensor_memory_s *tensors, const hal_ml_tensors_layout_s *layout)
+{
+  for (guint i = 0; i < layout->num_tensors; i++) {
+    if (!tensors[i].data || tensors[i].size != layout->size[i])
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+void
+hal_ml_client_get_tensors_layout (hal_ml_client_s *client,
+    hal_ml_tensors_layout_s *in_layout, hal_ml_tensors_layout_s *out_layout)
+{
+  if (in_layout)
+    *in_layout = client->in_layout;
+  if (out_layout)
+    *out_layout = client->out_layout;
+}
+
+int
+hal_ml_client_invoke (hal_ml_client_s *client, const void *input, void *output)
+{
+  const hal_ml_tensor_memory_s *in = (const hal_ml_tensor_memory_s *) input;
+  hal_ml_tensor_memory_s *out = (hal_ml_tensor_memory_s *) output;
+  hal_ml_ipc_header_s header;
+  int ret;
+
+  if (G_UNLIKELY (!in || !out || !hal_ml_client_check_tensors (in, &client->in_layout)
+          || !hal_ml_client_check_tensors (out, &client->out_layout))) {
+    _E ("The tensors do not match the layout of the shared instance.");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&client->lock);
+
+  for (guint i = 0; i < client->in_layout.num_tensors; i++) {
+    if (in[i].data != client->input[i].data)
+      memcpy (client->input[i].data, in[i].data, in[i].size);
+  }
+
+  ret = hal_ml_ipc_send (client->sock, HAL_ML_IPC_INVOKE, HAL_ML_ERROR_NONE, NULL, 0, -1);
+  if (ret == HAL_ML_ERROR_NONE)
+    ret = hal_ml_ipc_recv (client->sock, &header, NULL, 0, NULL);
+  if (ret == HAL_ML_ERROR_NONE)
+    ret = header.result;
+  else
+    _E ("Lost the connection to hal-ml daemon.");
+
+  if (ret == HAL_ML_ERROR_NONE) {
+    for (guint i = 0; i < client->out_layout.num_tensors; i++) {
+      if (out[i].data != client->output[i].data)
+        memcpy (out[i].data, client->output[i].data, out[i].size);
+    }
+  }
+
+  g_mutex_unlock (&client->lock);
+  return ret;
+}
+
+int
+hal_ml_get_shared_tensors (hal_ml_h handle, void **input, void **output)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+
+  if (!handle || !input || !output) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (!ml->client) {
+    _E ("The handle is not connected to hal-ml daemon.");
+    return HAL_ML_ERROR_NOT_SUPPORTED;
+  }
+
+  *input = ml->client->input;
+  *output = ml->client->output;
+  return HAL_ML_ERROR_NONE;
+}
@@ -0,0 +1,191 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - daemon protocol
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-ipc.c
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - daemon protocol
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "hal-api-ml-ipc.h"
+
+static int
+hal_ml_ipc_write_all (int sock, const guint8 *data, gsize size)
+{
+  while (size > 0) {
+    ssize_t n = send (sock, data, size, MSG_NOSIGNAL);
+
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return HAL_ML_ERROR_RUNTIME_ERROR;
+
+    data += n;
+    size -= n;
+  }
+
+  return HAL_ML_ERROR_NONE;
+}
+
+static int
+hal_ml_ipc_read_all (int sock, guint8 *data, gsize size)
+{
+  while (size > 0) {
+    ssize_t n = recv (sock, data, size, MSG_WAITALL);
+
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return HAL_ML_ERROR_RUNTIME_ERROR;
+
+    data += n;
+    size -= n;
+  }
+
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_ipc_send (int sock, hal_ml_ipc_cmd_e cmd, int result, const void *payload, gsize size, int fd)
+{
+  hal_ml_ipc_header_s header = { HAL_ML_IPC_MAGIC, cmd, result, (guint32) size };
+  union {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE (sizeof (int))];
+  } control;
+  struct iovec iov = { &header, sizeof (header) };
+  struct msghdr msg = { 0 };
+  ssize_t n;
+
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+
+  /* The descriptor travels with the header, so it is received by hal_ml_ipc_recv () at once. */
+  if (fd >= 0) {
+    struct cmsghdr *cmsg;
+
+    memset (&control, 0, sizeof (control));
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof (control.buf);
+    cmsg = CMSG_FIRSTHDR (&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN (sizeof (int));
+    memcpy (CMSG_DATA (cmsg), &fd, sizeof (int));
+  }
+
+  do {
+    n = sendmsg (sock, &msg, MSG_NOSIGNAL);
+  } while (n < 0 && errno == EINTR);
+
+  if (n <= 0)
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+
+  if ((gsize) n < sizeof (header)
+      && hal_ml_ipc_write_all (sock, (guint8 *) &header + n, sizeof (header) - n) != HAL_ML_ERROR_NONE)
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+
+  return hal_ml_ipc_write_all (sock, (const guint8 *) payload, size);
+}
+
+int
+hal_ml_ipc_recv (int sock, hal_ml_ipc_header_s *header, void *payload, gsize max, int *fd)
+{
+  union {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE (sizeof (int))];
+  } control;
+  struct iovec iov = { header, sizeof (*header) };
+  struct msghdr msg = { 0 };
+  struct cmsghdr *cmsg;
+  int received_fd = -1;
+  ssize_t n;
+
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof (control.buf);
+
+  do {
+    n = recvmsg (sock, &msg, MSG_CMSG_CLOEXEC);
+  } while (n < 0 && errno == EINTR);
+
+  if (n <= 0)
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+
+  for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+      memcpy (&received_fd, CMSG_DATA (cmsg), sizeof (int));
+  }
+
+  if (fd)
+    *fd = received_fd;
+  else if (received_fd >= 0)
+    close (received_fd);
+
+  if ((gsize) n < sizeof (*header)
+      && hal_ml_ipc_read_all (sock, (guint8 *) header + n, sizeof (*header) - n) != HAL_ML_ERROR_NONE)
+    goto error;
+
+  if (header->magic != HAL_ML_IPC_MAGIC || header->size > max) {
+    _E ("Got an invalid message (cmd %u, %u bytes).", header->cmd, header->size);
+    goto error;
+  }
+
+  if (hal_ml_ipc_read_all (sock, (guint8 *) payload, header->size) != HAL_ML_ERROR_NONE)
+    goto error;
+
+  return HAL_ML_ERROR_NONE;
+
+error:
+  if (fd && *fd >= 0) {
+    close (*fd);
+    *fd = -1;
+  }
+  return HAL_ML_ERROR_RUNTIME_ERROR;
+}
+
+gsize
+hal_ml_ipc_shm_size (const hal_ml_tensors_layout_s *in_layout, const hal_ml_tensors_layout_s *out_layout)
+{
+  gsize size = 0;
+
+  for (guint i = 0; i < in_layout->num_tensors; i++)
+    size += HAL_ML_TENSOR_ALIGN_UP (in_layout->size[i]);
+  for (guint i = 0; i < out_layout->num_tensors; i++)
+    size += HAL_ML_TENSOR_ALIGN_UP (out_layout->size[i]);
+
+  return size;
+}
+
+void
+hal_ml_ipc_map_tensors (gpointer base, const hal_ml_tensors_layout_s *in_layout,
+    const hal_ml_tensors_layout_s *out_layout, hal_ml_tensor_memory_s *input,
+    hal_ml_tensor_memory_s *output)
+{
+  guint8 *data = (guint8 *) base;
+
+  for (guint i = 0; i < in_layout->num_tensors; i++) {
+    input[i].data = data;
+    input[i].size = in_layout->size[i];
+    data += HAL_ML_TENSOR_ALIGN_UP (in_layout->size[i]);
+  }
+  memset (&input[in_layout->num_tensors], 0, sizeof (hal_ml_tensor_memory_s));
+
+  for (guint i = 0; i < out_layout->num_tensors; i++) {
+    output[i].data = data;
+    output[i].size = out_layout->size[i];
+    data += HAL_ML_TENSOR_ALIGN_UP (out_layout->size[i]);
+  }
+  memset (&output[out_layout->num_tensors], 0, sizeof (hal_ml_tensor_memory_s));
+}
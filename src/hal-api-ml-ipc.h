@@ -0,0 +1,72 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - daemon protocol
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-ipc.h
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - daemon protocol
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * A client sends HAL_ML_IPC_CREATE with the instance name over a Unix socket.
+ * The daemon replies with the tensor layouts of the instance and passes a
+ * sealed memfd holding the input and output tensors of this client. After
+ * that, HAL_ML_IPC_INVOKE carries no payload: both sides map the same memfd
+ * and only the header and the result cross the socket.
+ */
+
+#ifndef __HAL_API_ML_IPC__
+#define __HAL_API_ML_IPC__
+
+#include "hal-api-ml-private.h"
+
+#define HAL_ML_IPC_MAGIC (0x484d4c31U) /* "HML1" */
+#define HAL_ML_IPC_NAME_MAX (256) /* including the terminating null */
+
+typedef enum {
+  HAL_ML_IPC_CREATE = 1,
+  HAL_ML_IPC_INVOKE,
+} hal_ml_ipc_cmd_e;
+
+typedef struct _hal_ml_ipc_header_s {
+  guint32 magic;
+  guint32 cmd;
+  gint32 result;
+  guint32 size; /* payload size in bytes */
+} hal_ml_ipc_header_s;
+
+typedef struct _hal_ml_ipc_create_reply_s {
+  hal_ml_tensors_layout_s in_layout;
+  hal_ml_tensors_layout_s out_layout;
+  guint64 shm_size;
+} hal_ml_ipc_create_reply_s;
+
+/**
+ * @brief Sends a message, and @a fd with it if it is not negative.
+ */
+int hal_ml_ipc_send (int sock, hal_ml_ipc_cmd_e cmd, int result, const void *payload, gsize size, int fd);
+
+/**
+ * @brief Receives a message. The payload should fit in @a max bytes.
+ * @param[out] fd The descriptor passed with the message, or -1. It can be NULL if no descriptor is expected.
+ */
+int hal_ml_ipc_recv (int sock, hal_ml_ipc_header_s *header, void *payload, gsize max, int *fd);
+
+/**
+ * @brief Returns the size of the shared memory for the tensors of the given layouts.
+ */
+gsize hal_ml_ipc_shm_size (const hal_ml_tensors_layout_s *in_layout, const hal_ml_tensors_layout_s *out_layout);
+
+/**
+ * @brief Fills @a input and @a output with the tensors in the shared memory at @a base.
+ * @details Each array should have room for num_tensors + 1 entries. The last entry is zeroed.
+ */
+void hal_ml_ipc_map_tensors (gpointer base, const hal_ml_tensors_layout_s *in_layout,
+    const hal_ml_tensors_layout_s *out_layout, hal_ml_tensor_memory_s *input,
+    hal_ml_tensor_memory_s *output);
+
+#endif /* __HAL_API_ML_IPC__ */
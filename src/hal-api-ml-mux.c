@@ -0,0 +1,442 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - model multiplexer
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-mux.c
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - model multiplexer
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * A mux hosts more models than the device can keep configured at once. The
+ * resident models are kept in LRU order within the instance and memory
+ * budget, and a model is loaded (hal_ml_create + configure_instance) when it
+ * is requested. The mux also counts which model follows which, and with
+ * prefetch enabled a background thread loads the likely next model while the
+ * current one runs.
+ */
+
+#include "hal-api-ml-private.h"
+
+typedef struct _hal_ml_mux_model_s {
+  gchar *id;
+  const void *prop;
+  gsize cost;
+
+  hal_ml_h handle; /* NULL if not resident */
+  gboolean loading;
+  gboolean busy; /* being invoked */
+  gboolean prefetched; /* loaded by prefetch and not requested yet */
+  GHashTable *successors; /* model -> number of times it was requested right after this one */
+} hal_ml_mux_model_s;
+
+typedef struct _hal_ml_mux_s {
+  GMutex lock;
+  GCond cond;
+  gchar *backend_name;
+  guint max_instances;
+  gsize memory_budget;
+
+  GHashTable *models;
+  GQueue lru; /* resident models, the most recently used first */
+  guint resident; /* including the ones being loaded or evicted */
+  gsize memory_used;
+  guint evicting; /* evicted models whose instance is being destroyed */
+  hal_ml_mux_model_s *last;
+
+  gboolean prefetch;
+  hal_ml_mux_model_s *prefetch_target;
+  gboolean stopping;
+  GThread *prefetch_thread;
+
+  hal_ml_mux_stats_s stats;
+} hal_ml_mux_s;
+
+static void
+hal_ml_mux_model_free (gpointer data)
+{
+  hal_ml_mux_model_s *model = (hal_ml_mux_model_s *) data;
+
+  if (model->handle)
+    hal_ml_destroy (model->handle);
+  g_hash_table_destroy (model->successors);
+  g_free (model->id);
+  g_free (model);
+}
+
+static gboolean
+hal_ml_mux_has_room (hal_ml_mux_s *mux, gsize cost)
+{
+  if (mux->resident + 1 > mux->max_instances)
+    return FALSE;
+
+  return (mux->memory_budget == 0 || mux->memory_used + cost <= mux->memory_budget);
+}
+
+/**
+ * @brief Evicts the least recently used model which is idle and not @a keep.
+ * @return FALSE if there is no model to evict. Call this with mux->lock held.
+ */
+static gboolean
+hal_ml_mux_evict_one (hal_ml_mux_s *mux, hal_ml_mux_model_s *keep)
+{
+  hal_ml_mux_model_s *victim = NULL;
+  hal_ml_h handle;
+
+  for (GList *l = mux->lru.tail; l; l = l->prev) {
+    hal_ml_mux_model_s *model = (hal_ml_mux_model_s *) l->data;
+
+    if (!model->busy && !model->loading && model != keep) {
+      victim = model;
+      break;
+    }
+  }
+
+  if (!victim)
+    return FALSE;
+
+  _D ("Evicting model %s", victim->id);
+  g_queue_remove (&mux->lru, victim);
+  handle = victim->handle;
+  victim->handle = NULL;
+  victim->prefetched = FALSE;
+  mux->evicting++;
+  mux->stats.evictions++;
+
+  /* The victim is not reachable anymore, so its handle can be destroyed without the lock.
+   * Its room is kept until then, so no model is loaded while the victim is still on the device. */
+  g_mutex_unlock (&mux->lock);
+  hal_ml_destroy (handle);
+  g_mutex_lock (&mux->lock);
+
+  mux->evicting--;
+  mux->resident--;
+  mux->memory_used -= victim->cost;
+  g_cond_broadcast (&mux->cond);
+
+  return TRUE;
+}
+
+/**
+ * @brief Creates and configures the instance of @a model. Call this with mux->lock held.
+ * @details The room for the model should be reserved by the caller. The lock is released while loading.
+ */
+static int
+hal_ml_mux_load (hal_ml_mux_s *mux, hal_ml_mux_model_s *model)
+{
+  hal_ml_h handle = NULL;
+  hal_ml_param_h param = NULL;
+  int ret;
+
+  model->loading = TRUE;
+  g_mutex_unlock (&mux->lock);
+
+  ret = hal_ml_create (mux->backend_name, &handle);
+  if (ret == HAL_ML_ERROR_NONE) {
+    ret = hal_ml_param_create (&param);
+    if (ret == HAL_ML_ERROR_NONE)
+      ret = hal_ml_param_set (param, "properties", (void *) model->prop);
+    if (ret == HAL_ML_ERROR_NONE)
+      ret = hal_ml_request (handle, "configure_instance", param);
+    if (param)
+      hal_ml_param_destroy (param);
+
+    if (ret != HAL_ML_ERROR_NONE) {
+      hal_ml_destroy (handle);
+      handle = NULL;
+    }
+  }
+
+  g_mutex_lock (&mux->lock);
+  model->loading = FALSE;
+
+  if (ret == HAL_ML_ERROR_NONE) {
+    model->handle = handle;
+    g_queue_push_head (&mux->lru, model);
+  } else {
+    _E ("Failed to load model %s (%d).", model->id, ret);
+    mux->resident--;
+    mux->memory_used -= model->cost;
+  }
+
+  g_cond_broadcast (&mux->cond);
+  return ret;
+}
+
+static hal_ml_mux_model_s *
+hal_ml_mux_predict_next (hal_ml_mux_s *mux, hal_ml_mux_model_s *model)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  hal_ml_mux_model_s *best = NULL;
+  guint best_count = 0;
+
+  g_hash_table_iter_init (&iter, model->successors);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    if (GPOINTER_TO_UINT (value) > best_count) {
+      best_count = GPOINTER_TO_UINT (value);
+      best = (hal_ml_mux_model_s *) key;
+    }
+  }
+
+  return best;
+}
+
+static gpointer
+hal_ml_mux_prefetch_thread (gpointer data)
+{
+  hal_ml_mux_s *mux = (hal_ml_mux_s *) data;
+  hal_ml_mux_model_s *target;
+
+  g_mutex_lock (&mux->lock);
+  while (!mux->stopping) {
+    if (!mux->prefetch_target) {
+      g_cond_wait (&mux->cond, &mux->lock);
+      continue;
+    }
+
+    target = mux->prefetch_target;
+    mux->prefetch_target = NULL;
+
+    if (target->handle || target->loading)
+      continue;
+
+    /* Never evict the model just requested for a guess, nor more than needed. */
+    while (!hal_ml_mux_has_room (mux, target->cost)) {
+      if (mux->evicting > 0 || !hal_ml_mux_evict_one (mux, mux->last))
+        break;
+    }
+
+    if (!hal_ml_mux_has_room (mux, target->cost) || target->handle || target->loading)
+      continue;
+
+    mux->resident++;
+    mux->memory_used += target->cost;
+    if (hal_ml_mux_load (mux, target) == HAL_ML_ERROR_NONE) {
+      target->prefetched = TRUE;
+      mux->stats.prefetches++;
+    }
+  }
+  g_mutex_unlock (&mux->lock);
+
+  return NULL;
+}
+
+int
+hal_ml_mux_create (const char *backend_name, unsigned int max_instances,
+    size_t memory_budget, hal_ml_mux_h *mux)
+{
+  hal_ml_mux_s *m;
+
+  if (!backend_name || !mux || max_instances == 0) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  m = g_new0 (hal_ml_mux_s, 1);
+  g_mutex_init (&m->lock);
+  g_cond_init (&m->cond);
+  g_queue_init (&m->lru);
+  m->backend_name = g_strdup (backend_name);
+  m->max_instances = max_instances;
+  m->memory_budget = memory_budget;
+  m->models = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, hal_ml_mux_model_free);
+
+  m->prefetch_thread = g_thread_try_new ("hal-ml-mux", hal_ml_mux_prefetch_thread, m, NULL);
+  if (!m->prefetch_thread) {
+    _E ("Failed to create the prefetch thread.");
+    g_hash_table_destroy (m->models);
+    g_free (m->backend_name);
+    g_mutex_clear (&m->lock);
+    g_cond_clear (&m->cond);
+    g_free (m);
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  *mux = (hal_ml_mux_h) m;
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_mux_destroy (hal_ml_mux_h mux)
+{
+  hal_ml_mux_s *m = (hal_ml_mux_s *) mux;
+
+  if (!mux) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&m->lock);
+  m->stopping = TRUE;
+  g_cond_broadcast (&m->cond);
+  g_mutex_unlock (&m->lock);
+  g_thread_join (m->prefetch_thread);
+
+  g_hash_table_destroy (m->models);
+  g_queue_clear (&m->lru);
+  g_free (m->backend_name);
+  g_mutex_clear (&m->lock);
+  g_cond_clear (&m->cond);
+  g_free (m);
+
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_mux_add_model (hal_ml_mux_h mux, const char *model_id, const void *prop, size_t memory_cost)
+{
+  hal_ml_mux_s *m = (hal_ml_mux_s *) mux;
+  hal_ml_mux_model_s *model;
+  int ret = HAL_ML_ERROR_NONE;
+
+  if (!mux || !model_id || !prop) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (m->memory_budget > 0 && memory_cost > m->memory_budget) {
+    _E ("Model %s (%zu bytes) does not fit in the budget (%zu bytes).", model_id,
+        memory_cost, m->memory_budget);
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&m->lock);
+  if (g_hash_table_contains (m->models, model_id)) {
+    _E ("Model %s is already registered.", model_id);
+    ret = HAL_ML_ERROR_INVALID_PARAMETER;
+  } else {
+    model = g_new0 (hal_ml_mux_model_s, 1);
+    model->id = g_strdup (model_id);
+    model->prop = prop;
+    model->cost = memory_cost;
+    model->successors = g_hash_table_new (g_direct_hash, g_direct_equal);
+    g_hash_table_insert (m->models, model->id, model);
+  }
+  g_mutex_unlock (&m->lock);
+
+  return ret;
+}
+
+int
+hal_ml_mux_set_prefetch (hal_ml_mux_h mux, bool enable)
+{
+  hal_ml_mux_s *m = (hal_ml_mux_s *) mux;
+
+  if (!mux) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&m->lock);
+  m->prefetch = enable;
+  g_mutex_unlock (&m->lock);
+
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_mux_invoke (hal_ml_mux_h mux, const char *model_id, const void *input, void *output)
+{
+  hal_ml_mux_s *m = (hal_ml_mux_s *) mux;
+  hal_ml_mux_model_s *model, *next;
+  hal_ml_h handle;
+  int ret = HAL_ML_ERROR_NONE;
+
+  if (G_UNLIKELY (!mux || !model_id)) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&m->lock);
+  model = (hal_ml_mux_model_s *) g_hash_table_lookup (m->models, model_id);
+  if (!model) {
+    g_mutex_unlock (&m->lock);
+    _E ("Model %s is not registered.", model_id);
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (m->last) {
+    guint count = GPOINTER_TO_UINT (g_hash_table_lookup (m->last->successors, model));
+    g_hash_table_insert (m->last->successors, model, GUINT_TO_POINTER (count + 1));
+  }
+  m->last = model;
+
+  while (TRUE) {
+    if (model->loading || model->busy) {
+      g_cond_wait (&m->cond, &m->lock);
+      continue;
+    }
+
+    if (model->handle) {
+      m->stats.hits++;
+      if (model->prefetched)
+        m->stats.prefetch_hits++;
+      break;
+    }
+
+    if (!hal_ml_mux_has_room (m, model->cost)) {
+      /* Wait for the evictions in progress to free their room, or for a busy model
+       * to become idle if nothing can be evicted now. */
+      if (m->evicting > 0 || !hal_ml_mux_evict_one (m, NULL))
+        g_cond_wait (&m->cond, &m->lock);
+      continue;
+    }
+
+    m->resident++;
+    m->memory_used += model->cost;
+    m->stats.misses++;
+    ret = hal_ml_mux_load (m, model);
+    if (ret != HAL_ML_ERROR_NONE) {
+      g_mutex_unlock (&m->lock);
+      return ret;
+    }
+    break;
+  }
+
+  model->prefetched = FALSE;
+  model->busy = TRUE;
+  handle = model->handle;
+  g_queue_remove (&m->lru, model);
+  g_queue_push_head (&m->lru, model);
+  g_mutex_unlock (&m->lock);
+
+  ret = hal_ml_request_invoke (handle, input, output);
+
+  g_mutex_lock (&m->lock);
+  model->busy = FALSE;
+
+  if (m->prefetch) {
+    next = hal_ml_mux_predict_next (m, model);
+    if (next && next != model && !next->handle && !next->loading)
+      m->prefetch_target = next;
+  }
+
+  g_cond_broadcast (&m->cond);
+  g_mutex_unlock (&m->lock);
+
+  return ret;
+}
+
+int
+hal_ml_mux_get_stats (hal_ml_mux_h mux, hal_ml_mux_stats_s *stats)
+{
+  hal_ml_mux_s *m = (hal_ml_mux_s *) mux;
+
+  if (!mux || !stats) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&m->lock);
+  *stats = m->stats;
+  stats->resident = g_queue_get_length (&m->lru);
+  stats->memory_used = m->memory_used;
+  g_mutex_unlock (&m->lock);
+
+  return HAL_ML_ERROR_NONE;
+}
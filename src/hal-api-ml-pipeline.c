@@ -0,0 +1,551 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - pipeline of hal-ml instances
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-pipeline.c
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - pipeline of hal-ml instances
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * A pipeline runs a cascade of models (e.g., detector -> classifier) with one
+ * thread per stage. A stage invokes its model into an output buffer set taken
+ * from its own pool, and the frame carries the buffer set to the next stage,
+ * which uses it as its input directly. The buffer set goes back to the pool
+ * once the next stage is done with it, so the number of frames in flight is
+ * bounded by the pools and the queues between the stages.
+ */
+
+#include "hal-api-ml-private.h"
+
+/**
+ * @brief Blocking queue with a maximum length.
+ */
+typedef struct _hal_ml_bqueue_s {
+  GMutex lock;
+  GCond cond;
+  GQueue items;
+  guint max_length;
+} hal_ml_bqueue_s;
+
+typedef struct _hal_ml_pipeline_frame_s {
+  void *frame_data;
+  const hal_ml_tensor_memory_s *input; /* input of the next stage */
+  hal_ml_tensor_memory_s *held; /* buffer set of the previous stage */
+  hal_ml_bqueue_s *held_pool;
+  int result;
+  gboolean eos;
+} hal_ml_pipeline_frame_s;
+
+typedef struct _hal_ml_pipeline_stage_s {
+  struct _hal_ml_pipeline_s *pipeline;
+  guint index;
+  hal_ml_h handle;
+  hal_ml_tensors_layout_s in_layout;
+  hal_ml_tensors_layout_s out_layout;
+  hal_ml_pipeline_transform_cb transform;
+  void *user_data;
+
+  hal_ml_tensor_memory_s *transformed; /* input buffer set for transform */
+  GPtrArray *buffers; /* all output buffer sets */
+  hal_ml_bqueue_s frames;
+  hal_ml_bqueue_s pool;
+  GThread *thread;
+} hal_ml_pipeline_stage_s;
+
+typedef struct _hal_ml_pipeline_s {
+  GMutex lock;
+  GCond cond;
+  guint queue_depth;
+  GPtrArray *stages;
+  hal_ml_pipeline_result_cb result_cb;
+  void *result_user_data;
+  gboolean running;
+  gboolean stopping; /* Set while stop drains the stages, which rejects new frames */
+  guint pushing; /* The number of hal_ml_pipeline_push () calls handing a frame to the first stage */
+} hal_ml_pipeline_s;
+
+static void
+hal_ml_bqueue_init (hal_ml_bqueue_s *q, guint max_length)
+{
+  g_mutex_init (&q->lock);
+  g_cond_init (&q->cond);
+  g_queue_init (&q->items);
+  q->max_length = max_length;
+}
+
+static void
+hal_ml_bqueue_clear (hal_ml_bqueue_s *q)
+{
+  g_queue_clear (&q->items);
+  g_mutex_clear (&q->lock);
+  g_cond_clear (&q->cond);
+}
+
+static void
+hal_ml_bqueue_push (hal_ml_bqueue_s *q, gpointer item)
+{
+  g_mutex_lock (&q->lock);
+  while (g_queue_get_length (&q->items) >= q->max_length)
+    g_cond_wait (&q->cond, &q->lock);
+  g_queue_push_tail (&q->items, item);
+  g_cond_broadcast (&q->cond);
+  g_mutex_unlock (&q->lock);
+}
+
+static gpointer
+hal_ml_bqueue_pop (hal_ml_bqueue_s *q)
+{
+  gpointer item;
+
+  g_mutex_lock (&q->lock);
+  while (g_queue_is_empty (&q->items))
+    g_cond_wait (&q->cond, &q->lock);
+  item = g_queue_pop_head (&q->items);
+  g_cond_broadcast (&q->cond);
+  g_mutex_unlock (&q->lock);
+
+  return item;
+}
+
+static void
+hal_ml_pipeline_stage_free_buffers (hal_ml_pipeline_stage_s *stage)
+{
+  g_queue_clear (&stage->pool.items);
+  if (stage->buffers)
+    g_ptr_array_free (stage->buffers, TRUE);
+  hal_ml_tensors_free (stage->transformed);
+  stage->buffers = NULL;
+  stage->transformed = NULL;
+}
+
+/**
+ * @brief Allocates the buffer sets of a stage, or none of them.
+ * @details The layouts are checked when the stage is added, so this fails only without memory.
+ */
+static int
+hal_ml_pipeline_stage_alloc_buffers (hal_ml_pipeline_stage_s *stage)
+{
+  /* The buffers are written and read by the stage's handle, so they live on its node. */
+  int numa_node = hal_ml_placement_get_node ((hal_ml_s *) stage->handle);
+  void *tensors;
+  int ret = HAL_ML_ERROR_NONE;
+
+  stage->buffers = g_ptr_array_new_with_free_func ((GDestroyNotify) hal_ml_tensors_free);
+  for (guint b = 0; ret == HAL_ML_ERROR_NONE && b < stage->pool.max_length; b++) {
+    ret = hal_ml_tensors_alloc_on_node (&stage->out_layout, numa_node, &tensors);
+    if (ret == HAL_ML_ERROR_NONE) {
+      g_ptr_array_add (stage->buffers, tensors);
+      g_queue_push_tail (&stage->pool.items, tensors);
+    }
+  }
+
+  if (ret == HAL_ML_ERROR_NONE && stage->transform) {
+    ret = hal_ml_tensors_alloc_on_node (&stage->in_layout, numa_node, &tensors);
+    if (ret == HAL_ML_ERROR_NONE)
+      stage->transformed = (hal_ml_tensor_memory_s *) tensors;
+  }
+
+  if (ret != HAL_ML_ERROR_NONE) {
+    _E ("Failed to allocate the buffers of stage %u.", stage->index);
+    hal_ml_pipeline_stage_free_buffers (stage);
+  }
+
+  return ret;
+}
+
+static void
+hal_ml_pipeline_release_held (hal_ml_pipeline_frame_s *frame)
+{
+  if (frame->held) {
+    hal_ml_bqueue_push (frame->held_pool, frame->held);
+    frame->held = NULL;
+    frame->held_pool = NULL;
+  }
+}
+
+static gpointer
+hal_ml_pipeline_stage_thread (gpointer data)
+{
+  hal_ml_pipeline_stage_s *stage = (hal_ml_pipeline_stage_s *) data;
+  hal_ml_pipeline_s *pipeline = stage->pipeline;
+  hal_ml_pipeline_stage_s *next = NULL;
+  hal_ml_pipeline_frame_s *frame;
+  hal_ml_tensor_memory_s *output;
+  const hal_ml_tensor_memory_s *input;
+  int ret;
+
+  hal_ml_placement_thread_init ();
+
+  if (stage->index + 1 < pipeline->stages->len)
+    next = (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipeline->stages, stage->index + 1);
+
+  while (TRUE) {
+    frame = (hal_ml_pipeline_frame_s *) hal_ml_bqueue_pop (&stage->frames);
+
+    if (frame->eos) {
+      if (next)
+        hal_ml_bqueue_push (&next->frames, frame);
+      else
+        g_free (frame);
+      break;
+    }
+
+    if (frame->result == HAL_ML_ERROR_NONE) {
+      input = frame->input;
+      ret = HAL_ML_ERROR_NONE;
+
+      if (stage->transform) {
+        ret = stage->transform (input, stage->transformed, stage->user_data);
+        input = stage->transformed;
+      }
+
+      output = NULL;
+      if (ret == HAL_ML_ERROR_NONE) {
+        output = (hal_ml_tensor_memory_s *) hal_ml_bqueue_pop (&stage->pool);
+        ret = hal_ml_request_invoke (stage->handle, input, output);
+      }
+
+      /* The previous stage's buffers are not needed anymore. */
+      hal_ml_pipeline_release_held (frame);
+
+      if (ret == HAL_ML_ERROR_NONE) {
+        frame->input = output;
+        frame->held = output;
+        frame->held_pool = &stage->pool;
+      } else {
+        _E ("Stage %u of the pipeline failed (%d).", stage->index, ret);
+        if (output)
+          hal_ml_bqueue_push (&stage->pool, output);
+        frame->input = NULL;
+        frame->result = ret;
+      }
+    }
+
+    if (next) {
+      hal_ml_bqueue_push (&next->frames, frame);
+    } else {
+      pipeline->result_cb (frame->frame_data, frame->input, frame->result,
+          pipeline->result_user_data);
+      hal_ml_pipeline_release_held (frame);
+      g_free (frame);
+    }
+  }
+
+  hal_ml_placement_thread_exit ();
+  return NULL;
+}
+
+static void
+hal_ml_pipeline_stage_free (gpointer data)
+{
+  hal_ml_pipeline_stage_s *stage = (hal_ml_pipeline_stage_s *) data;
+
+  hal_ml_bqueue_clear (&stage->frames);
+  hal_ml_bqueue_clear (&stage->pool);
+  if (stage->buffers)
+    g_ptr_array_free (stage->buffers, TRUE);
+  hal_ml_tensors_free (stage->transformed);
+  g_free (stage);
+}
+
+int
+hal_ml_pipeline_create (unsigned int queue_depth, hal_ml_pipeline_h *pipeline)
+{
+  if (!pipeline || queue_depth == 0) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  hal_ml_pipeline_s *pipe = g_new0 (hal_ml_pipeline_s, 1);
+  if (!pipe) {
+    return HAL_ML_ERROR_OUT_OF_MEMORY;
+  }
+
+  g_mutex_init (&pipe->lock);
+  g_cond_init (&pipe->cond);
+  pipe->queue_depth = queue_depth;
+  pipe->stages = g_ptr_array_new_with_free_func (hal_ml_pipeline_stage_free);
+
+  *pipeline = (hal_ml_pipeline_h) pipe;
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_pipeline_destroy (hal_ml_pipeline_h pipeline)
+{
+  hal_ml_pipeline_s *pipe = (hal_ml_pipeline_s *) pipeline;
+
+  if (!pipeline) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  hal_ml_pipeline_stop (pipeline);
+
+  g_ptr_array_free (pipe->stages, TRUE);
+  g_mutex_clear (&pipe->lock);
+  g_cond_clear (&pipe->cond);
+  g_free (pipe);
+
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_pipeline_add_stage (hal_ml_pipeline_h pipeline, hal_ml_h handle,
+    const hal_ml_tensors_layout_s *in_layout, const hal_ml_tensors_layout_s *out_layout,
+    hal_ml_pipeline_transform_cb transform, void *user_data)
+{
+  hal_ml_pipeline_s *pipe = (hal_ml_pipeline_s *) pipeline;
+  hal_ml_pipeline_stage_s *stage;
+  hal_ml_tensors_layout_s handle_in, handle_out;
+  int ret = HAL_ML_ERROR_NONE;
+
+  if (!pipeline || !handle) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (!in_layout && !out_layout) {
+    ret = hal_ml_get_tensors_layout (handle, &handle_in, &handle_out);
+    if (ret != HAL_ML_ERROR_NONE)
+      return ret;
+    in_layout = &handle_in;
+    out_layout = &handle_out;
+  }
+
+  if (!hal_ml_layout_is_valid (in_layout) || !hal_ml_layout_is_valid (out_layout)) {
+    _E ("Got invalid tensor layout");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&pipe->lock);
+  if (pipe->running) {
+    _E ("Cannot add a stage to the running pipeline");
+    ret = HAL_ML_ERROR_INVALID_PARAMETER;
+    goto done;
+  }
+
+  if (!transform && pipe->stages->len > 0) {
+    hal_ml_pipeline_stage_s *prev = (hal_ml_pipeline_stage_s *) g_ptr_array_index (
+        pipe->stages, pipe->stages->len - 1);
+
+    if (!hal_ml_layout_is_equal (&prev->out_layout, in_layout)) {
+      _E ("The output of stage %u does not match the input of the new stage; transform is required.",
+          prev->index);
+      ret = HAL_ML_ERROR_INVALID_PARAMETER;
+      goto done;
+    }
+  }
+
+  stage = g_new0 (hal_ml_pipeline_stage_s, 1);
+  stage->pipeline = pipe;
+  stage->index = pipe->stages->len;
+  stage->handle = handle;
+  stage->in_layout = *in_layout;
+  stage->out_layout = *out_layout;
+  stage->transform = transform;
+  stage->user_data = user_data;
+  hal_ml_bqueue_init (&stage->frames, pipe->queue_depth);
+  /* Buffers being filled, waiting in the next queue, and being read by the next stage */
+  hal_ml_bqueue_init (&stage->pool, pipe->queue_depth + 2);
+
+  g_ptr_array_add (pipe->stages, stage);
+
+done:
+  g_mutex_unlock (&pipe->lock);
+  return ret;
+}
+
+int
+hal_ml_pipeline_set_result_cb (hal_ml_pipeline_h pipeline,
+    hal_ml_pipeline_result_cb callback, void *user_data)
+{
+  hal_ml_pipeline_s *pipe = (hal_ml_pipeline_s *) pipeline;
+  int ret = HAL_ML_ERROR_NONE;
+
+  if (!pipeline || !callback) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&pipe->lock);
+  if (pipe->running) {
+    _E ("Cannot change the callback of the running pipeline");
+    ret = HAL_ML_ERROR_INVALID_PARAMETER;
+  } else {
+    pipe->result_cb = callback;
+    pipe->result_user_data = user_data;
+  }
+  g_mutex_unlock (&pipe->lock);
+
+  return ret;
+}
+
+int
+hal_ml_pipeline_start (hal_ml_pipeline_h pipeline)
+{
+  hal_ml_pipeline_s *pipe = (hal_ml_pipeline_s *) pipeline;
+  int ret = HAL_ML_ERROR_NONE;
+  guint i, allocated, started = 0;
+
+  if (!pipeline) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&pipe->lock);
+  if (pipe->running || pipe->stages->len == 0 || !pipe->result_cb) {
+    _E ("The pipeline is running, or it has no stage or result callback.");
+    ret = HAL_ML_ERROR_INVALID_PARAMETER;
+    goto done;
+  }
+
+  /* The stages added after the last start have no buffers yet; they are the last ones. */
+  for (i = 0; i < pipe->stages->len; i++) {
+    hal_ml_pipeline_stage_s *stage = (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, i);
+
+    if (!stage->buffers)
+      break;
+  }
+
+  for (allocated = i; allocated < pipe->stages->len; allocated++) {
+    ret = hal_ml_pipeline_stage_alloc_buffers (
+        (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, allocated));
+    if (ret != HAL_ML_ERROR_NONE)
+      break;
+  }
+
+  if (ret != HAL_ML_ERROR_NONE) {
+    while (allocated > i)
+      hal_ml_pipeline_stage_free_buffers (
+          (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, --allocated));
+    goto done;
+  }
+
+  for (i = 0; i < pipe->stages->len; i++) {
+    hal_ml_pipeline_stage_s *stage = (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, i);
+
+    stage->thread = g_thread_try_new ("hal-ml-pipeline", hal_ml_pipeline_stage_thread, stage, NULL);
+    if (!stage->thread) {
+      _E ("Failed to create the thread of stage %u.", i);
+      ret = HAL_ML_ERROR_RUNTIME_ERROR;
+      break;
+    }
+    started++;
+  }
+
+  if (ret != HAL_ML_ERROR_NONE && started > 0) {
+    /* Only the first stages are running; let them drain and exit. */
+    hal_ml_pipeline_stage_s *first = (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, 0);
+    hal_ml_pipeline_stage_s *after = (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, started);
+    hal_ml_pipeline_frame_s *eos = g_new0 (hal_ml_pipeline_frame_s, 1);
+
+    eos->eos = TRUE;
+    hal_ml_bqueue_push (&first->frames, eos);
+    for (i = 0; i < started; i++) {
+      hal_ml_pipeline_stage_s *stage = (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, i);
+      g_thread_join (stage->thread);
+      stage->thread = NULL;
+    }
+    /* The last started stage forwarded the end-of-stream to the stage without thread. */
+    g_free (hal_ml_bqueue_pop (&after->frames));
+    goto done;
+  }
+
+  pipe->running = TRUE;
+
+done:
+  g_mutex_unlock (&pipe->lock);
+  return ret;
+}
+
+int
+hal_ml_pipeline_stop (hal_ml_pipeline_h pipeline)
+{
+  hal_ml_pipeline_s *pipe = (hal_ml_pipeline_s *) pipeline;
+  hal_ml_pipeline_frame_s *eos;
+
+  if (!pipeline) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&pipe->lock);
+  /* If another thread is stopping the pipeline, return when it is done. */
+  while (pipe->stopping)
+    g_cond_wait (&pipe->cond, &pipe->lock);
+
+  if (!pipe->running) {
+    g_mutex_unlock (&pipe->lock);
+    return HAL_ML_ERROR_NONE;
+  }
+
+  /* New frames are rejected from now on; wait for the frames being pushed to be queued. */
+  pipe->stopping = TRUE;
+  while (pipe->pushing > 0)
+    g_cond_wait (&pipe->cond, &pipe->lock);
+  g_mutex_unlock (&pipe->lock);
+
+  /* The end-of-stream frame goes through all stages after the frames pushed so far.
+   * The lock is not held, so the result callback can call the pipeline meanwhile. */
+  eos = g_new0 (hal_ml_pipeline_frame_s, 1);
+  eos->eos = TRUE;
+  hal_ml_bqueue_push (&((hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, 0))->frames, eos);
+
+  for (guint i = 0; i < pipe->stages->len; i++) {
+    hal_ml_pipeline_stage_s *stage = (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, i);
+    g_thread_join (stage->thread);
+    stage->thread = NULL;
+  }
+
+  g_mutex_lock (&pipe->lock);
+  pipe->running = FALSE;
+  pipe->stopping = FALSE;
+  g_cond_broadcast (&pipe->cond);
+  g_mutex_unlock (&pipe->lock);
+
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_pipeline_push (hal_ml_pipeline_h pipeline, const hal_ml_tensor_memory_s *input, void *frame_data)
+{
+  hal_ml_pipeline_s *pipe = (hal_ml_pipeline_s *) pipeline;
+  hal_ml_pipeline_stage_s *first;
+  hal_ml_pipeline_frame_s *frame;
+
+  if (G_UNLIKELY (!pipeline || !input)) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&pipe->lock);
+  if (!pipe->running || pipe->stopping) {
+    g_mutex_unlock (&pipe->lock);
+    _E ("The pipeline is not running");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+  first = (hal_ml_pipeline_stage_s *) g_ptr_array_index (pipe->stages, 0);
+  /* Stop waits for this frame, so it is queued before the end-of-stream. */
+  pipe->pushing++;
+  g_mutex_unlock (&pipe->lock);
+
+  frame = g_new0 (hal_ml_pipeline_frame_s, 1);
+  frame->frame_data = frame_data;
+  frame->input = input;
+  frame->result = HAL_ML_ERROR_NONE;
+
+  hal_ml_bqueue_push (&first->frames, frame);
+
+  g_mutex_lock (&pipe->lock);
+  if (--pipe->pushing == 0)
+    g_cond_broadcast (&pipe->cond);
+  g_mutex_unlock (&pipe->lock);
+
+  return HAL_ML_ERROR_NONE;
+}
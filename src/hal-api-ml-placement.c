@@ -0,0 +1,513 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - CPU and NUMA placement
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-placement.c
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - CPU and NUMA placement
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * The threads of HAL ML mark themselves with hal_ml_placement_thread_init ().
+ * Such a thread applies the placement of a handle to itself right before it
+ * invokes the handle, whenever the placement changed since it last did, so
+ * no thread is moved from outside. Each placement gets a generation number
+ * unique in the process, and a handle without a placement has generation 0,
+ * which the invoke path checks with a single atomic read.
+ *
+ * An isolated thread claims a CPU of the placement when it applies it, and
+ * keeps the claim until it applies another placement or exits with
+ * hal_ml_placement_thread_exit (). A claim is recorded with the generation
+ * of its placement, so a placement which is replaced releases the claims of
+ * its threads at once, and a thread never releases a CPU claimed since by
+ * another one.
+ *
+ * Migrations and remote invokes are observed with sched_getcpu () around
+ * each invoke, which does not enter the kernel, and the node of the CPU is
+ * looked up in a table read once from sysfs. The last CPU is kept per thread
+ * with the handle it was observed for, so a thread which interleaves the
+ * invokes of several handles only counts the migrations during each invoke,
+ * not the ones between them.
+ *
+ * The node of the first input and output tensors comes from get_mempolicy (),
+ * which is a system call, so each thread keeps the node of the last data
+ * pointers it saw and asks again only for another pointer. Tensors are
+ * usually reused across invokes; a page moved by the kernel under the same
+ * pointer is missed until the pointer changes.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* cpu_set_t, sched_setaffinity (), sched_getcpu () */
+#endif
+
+#include <sched.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+
+#include "hal-api-ml-private.h"
+
+#define HAL_ML_MAX_NUMA_NODES (1024)
+#define HAL_ML_NODEMASK_BITS (8 * sizeof (unsigned long))
+
+struct _hal_ml_placement_data_s {
+  cpu_set_t cpus;
+  int numa_node;
+  gboolean isolated;
+  gint gen; /* the generation of the handle when this placement was set */
+};
+
+/**
+ * @brief The state of a thread of HAL ML, or of another thread invoking a handle with a placement.
+ */
+typedef struct _hal_ml_placement_thread_s {
+  gboolean owned; /* a thread of HAL ML, which may be moved */
+  cpu_set_t default_cpus; /* the affinity the thread started with */
+  gint gen; /* the generation of the placement applied to the thread */
+  int claimed_cpu; /* the CPU claimed for an isolated placement, or -1 */
+  gint claimed_gen; /* the generation of the placement claimed_cpu is claimed for */
+  const hal_ml_s *last_ml; /* the handle last_cpu was observed for, or NULL */
+  int last_cpu;
+  const void *last_data[2]; /* the first input and output data pointers last looked up */
+  int last_data_node[2]; /* the NUMA node of last_data, or -1 */
+} hal_ml_placement_thread_s;
+
+static __thread hal_ml_placement_thread_s hal_ml_placement_thread;
+
+/* Protects the placements of all handles and the CPUs claimed by isolated threads. */
+G_LOCK_DEFINE_STATIC (hal_ml_placement_lock);
+static gint hal_ml_claim_gens[CPU_SETSIZE]; /* the generation of the placement which claimed each CPU, or 0 */
+static gint hal_ml_placement_last_gen = 0;
+
+/* The NUMA node of each CPU, or -1, read once from sysfs. */
+static gint16 hal_ml_cpu_nodes[CPU_SETSIZE];
+static gsize hal_ml_cpu_nodes_ready = 0;
+
+static gboolean
+hal_ml_placement_parse_cpus (const gchar *list, cpu_set_t *cpus)
+{
+  const gchar *p = list;
+
+  CPU_ZERO (cpus);
+  while (*p != '\0' && *p != '\n') {
+    guint64 first, last;
+    gchar *end;
+
+    first = g_ascii_strtoull (p, &end, 10);
+    if (end == p)
+      return FALSE;
+
+    last = first;
+    p = end;
+    if (*p == '-') {
+      p++;
+      last = g_ascii_strtoull (p, &end, 10);
+      if (end == p)
+        return FALSE;
+      p = end;
+    }
+
+    if (first > last || last >= CPU_SETSIZE)
+      return FALSE;
+
+    for (; first <= last; first++)
+      CPU_SET (first, cpus);
+
+    if (*p == ',')
+      p++;
+    else if (*p != '\0' && *p != '\n')
+      return FALSE;
+  }
+
+  return CPU_COUNT (cpus) > 0;
+}
+
+gboolean
+hal_ml_placement_node_is_valid (int numa_node)
+{
+  gchar path[64];
+
+  if (numa_node < 0 || numa_node >= HAL_ML_MAX_NUMA_NODES)
+    return FALSE;
+
+  snprintf (path, sizeof (path), "/sys/devices/system/node/node%d", numa_node);
+  return access (path, F_OK) == 0;
+}
+
+/**
+ * @brief Gets the CPUs of the NUMA node. Returns FALSE if the node has no CPU, e.g. a memory-only node.
+ */
+static gboolean
+hal_ml_placement_node_cpus (int numa_node, cpu_set_t *cpus)
+{
+  gchar path[64];
+  gchar *list = NULL;
+  gboolean ret;
+
+  snprintf (path, sizeof (path), "/sys/devices/system/node/node%d/cpulist", numa_node);
+  if (!g_file_get_contents (path, &list, NULL, NULL))
+    return FALSE;
+
+  ret = hal_ml_placement_parse_cpus (list, cpus);
+  g_free (list);
+  return ret;
+}
+
+static void
+hal_ml_placement_init_cpu_nodes (void)
+{
+  gchar *list = NULL;
+  cpu_set_t nodes, cpus;
+
+  if (!g_once_init_enter (&hal_ml_cpu_nodes_ready))
+    return;
+
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    hal_ml_cpu_nodes[cpu] = -1;
+
+  /* The node list has the format of a CPU list, and no more nodes than HAL_ML_MAX_NUMA_NODES. */
+  if (g_file_get_contents ("/sys/devices/system/node/online", &list, NULL, NULL)
+      && hal_ml_placement_parse_cpus (list, &nodes)) {
+    for (int node = 0; node < CPU_SETSIZE; node++) {
+      if (!CPU_ISSET (node, &nodes) || !hal_ml_placement_node_cpus (node, &cpus))
+        continue;
+
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET (cpu, &cpus))
+          hal_ml_cpu_nodes[cpu] = (gint16) node;
+      }
+    }
+  }
+  g_free (list);
+
+  g_once_init_leave (&hal_ml_cpu_nodes_ready, 1);
+}
+
+static void
+hal_ml_placement_set_nodemask (unsigned long *mask, int numa_node)
+{
+  mask[numa_node / HAL_ML_NODEMASK_BITS] |= 1UL << (numa_node % HAL_ML_NODEMASK_BITS);
+}
+
+int
+hal_ml_placement_bind_memory (void *addr, gsize size, int numa_node)
+{
+  unsigned long mask[HAL_ML_MAX_NUMA_NODES / HAL_ML_NODEMASK_BITS] = { 0 };
+
+  hal_ml_placement_set_nodemask (mask, numa_node);
+  if (syscall (SYS_mbind, addr, size, MPOL_BIND, mask, HAL_ML_MAX_NUMA_NODES + 1, 0) != 0) {
+    _W ("Failed to bind the memory to NUMA node %d.", numa_node);
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  return HAL_ML_ERROR_NONE;
+}
+
+/**
+ * @brief Releases the CPUs claimed for @a data by its threads. Call this with hal_ml_placement_lock held.
+ */
+static void
+hal_ml_placement_release_claims (hal_ml_placement_data_s *data)
+{
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (hal_ml_claim_gens[cpu] == data->gen)
+      hal_ml_claim_gens[cpu] = 0;
+  }
+}
+
+/**
+ * @brief Releases the CPU claimed by the calling thread, if still claimed. Call this with hal_ml_placement_lock held.
+ */
+static void
+hal_ml_placement_release_thread_claim (void)
+{
+  hal_ml_placement_thread_s *thread = &hal_ml_placement_thread;
+
+  if (thread->claimed_cpu >= 0 && hal_ml_claim_gens[thread->claimed_cpu] == thread->claimed_gen)
+    hal_ml_claim_gens[thread->claimed_cpu] = 0;
+  thread->claimed_cpu = -1;
+}
+
+/**
+ * @brief Claims a CPU of @a data for the calling thread. Call this with hal_ml_placement_lock held.
+ */
+static int
+hal_ml_placement_claim (hal_ml_placement_data_s *data)
+{
+  int first = -1;
+
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET (cpu, &data->cpus))
+      continue;
+
+    if (first < 0)
+      first = cpu;
+
+    if (hal_ml_claim_gens[cpu] == 0) {
+      hal_ml_claim_gens[cpu] = data->gen;
+      hal_ml_placement_thread.claimed_cpu = cpu;
+      hal_ml_placement_thread.claimed_gen = data->gen;
+      return cpu;
+    }
+  }
+
+  _W ("All CPUs of the isolated placement are claimed, sharing CPU %d.", first);
+  return first;
+}
+
+/**
+ * @brief Moves the calling thread of HAL ML to the placement of @a ml.
+ */
+static void
+hal_ml_placement_apply (hal_ml_s *ml, gint gen)
+{
+  unsigned long mask[HAL_ML_MAX_NUMA_NODES / HAL_ML_NODEMASK_BITS] = { 0 };
+  hal_ml_placement_data_s *data;
+  cpu_set_t cpus;
+  int numa_node = -1;
+
+  G_LOCK (hal_ml_placement_lock);
+  hal_ml_placement_release_thread_claim ();
+
+  data = ml->placement;
+  if (!data) {
+    cpus = hal_ml_placement_thread.default_cpus;
+  } else if (data->isolated) {
+    CPU_ZERO (&cpus);
+    CPU_SET (hal_ml_placement_claim (data), &cpus);
+    numa_node = data->numa_node;
+  } else {
+    /* Stay off the CPUs of isolated threads, unless nothing is left. */
+    CPU_ZERO (&cpus);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET (cpu, &data->cpus) && hal_ml_claim_gens[cpu] == 0)
+        CPU_SET (cpu, &cpus);
+    }
+    if (CPU_COUNT (&cpus) == 0)
+      cpus = data->cpus;
+    numa_node = data->numa_node;
+  }
+  G_UNLOCK (hal_ml_placement_lock);
+
+  if (sched_setaffinity (0, sizeof (cpus), &cpus) != 0)
+    _W ("Failed to set the CPU affinity of a thread of %s.", ml->backend_library_name);
+
+  /* Memory the backend allocates on this thread is preferably local. */
+  if (numa_node >= 0) {
+    hal_ml_placement_set_nodemask (mask, numa_node);
+    if (syscall (SYS_set_mempolicy, MPOL_PREFERRED, mask, HAL_ML_MAX_NUMA_NODES + 1) != 0)
+      _W ("Failed to prefer NUMA node %d for a thread of %s.", numa_node, ml->backend_library_name);
+  } else if (syscall (SYS_set_mempolicy, MPOL_DEFAULT, NULL, 0) != 0) {
+    _W ("Failed to reset the memory policy of a thread of %s.", ml->backend_library_name);
+  }
+
+  hal_ml_placement_thread.gen = gen;
+}
+
+static void
+hal_ml_placement_observe_cpu (hal_ml_s *ml, int cpu)
+{
+  hal_ml_placement_thread_s *thread = &hal_ml_placement_thread;
+
+  if (thread->last_ml == ml && thread->last_cpu != cpu)
+    hal_ml_counter_inc (&ml->placement_migrations);
+
+  thread->last_ml = ml;
+  thread->last_cpu = cpu;
+}
+
+/**
+ * @brief Checks whether the first tensor is on another node than @a numa_node. @a slot selects the per-thread cache.
+ */
+static gboolean
+hal_ml_placement_is_remote (const void *tensors, int numa_node, int slot)
+{
+  hal_ml_placement_thread_s *thread = &hal_ml_placement_thread;
+  const hal_ml_tensor_memory_s *mem = (const hal_ml_tensor_memory_s *) tensors;
+  int node = -1;
+
+  if (!mem || !mem[0].data)
+    return FALSE;
+
+  if (thread->last_data[slot] != mem[0].data) {
+    if (syscall (SYS_get_mempolicy, &node, NULL, 0, mem[0].data, MPOL_F_NODE | MPOL_F_ADDR) != 0)
+      node = -1;
+
+    thread->last_data[slot] = mem[0].data;
+    thread->last_data_node[slot] = node;
+  }
+
+  return thread->last_data_node[slot] >= 0 && thread->last_data_node[slot] != numa_node;
+}
+
+void
+hal_ml_placement_thread_init (void)
+{
+  hal_ml_placement_thread.owned = TRUE;
+  hal_ml_placement_thread.gen = 0;
+  hal_ml_placement_thread.claimed_cpu = -1;
+  if (sched_getaffinity (0, sizeof (cpu_set_t), &hal_ml_placement_thread.default_cpus) != 0)
+    CPU_ZERO (&hal_ml_placement_thread.default_cpus);
+}
+
+void
+hal_ml_placement_thread_exit (void)
+{
+  if (hal_ml_placement_thread.claimed_cpu < 0)
+    return;
+
+  G_LOCK (hal_ml_placement_lock);
+  hal_ml_placement_release_thread_claim ();
+  G_UNLOCK (hal_ml_placement_lock);
+}
+
+void
+hal_ml_placement_enter (hal_ml_s *ml)
+{
+  gint gen = g_atomic_int_get (&ml->placement_gen);
+  int cpu;
+
+  if (hal_ml_placement_thread.owned && hal_ml_placement_thread.gen != gen)
+    hal_ml_placement_apply (ml, gen);
+
+  if (g_atomic_int_get (&ml->placement_active) && (cpu = sched_getcpu ()) >= 0)
+    hal_ml_placement_observe_cpu (ml, cpu);
+}
+
+void
+hal_ml_placement_leave (hal_ml_s *ml, const void *input, const void *output)
+{
+  int cpu, node;
+  gboolean remote;
+
+  if (!g_atomic_int_get (&ml->placement_active) || (cpu = sched_getcpu ()) < 0)
+    return;
+
+  hal_ml_placement_observe_cpu (ml, cpu);
+  hal_ml_counter_inc (&ml->placement_invokes);
+
+  hal_ml_placement_init_cpu_nodes ();
+  node = (cpu < CPU_SETSIZE) ? hal_ml_cpu_nodes[cpu] : -1;
+  if (node < 0)
+    return;
+
+  /* Evaluate both, so each slot of the cache follows its pointer. */
+  remote = hal_ml_placement_is_remote (input, node, 0);
+  remote |= hal_ml_placement_is_remote (output, node, 1);
+  if (remote)
+    hal_ml_counter_inc (&ml->placement_remote_invokes);
+}
+
+int
+hal_ml_placement_get_node (hal_ml_s *ml)
+{
+  int numa_node = -1;
+
+  G_LOCK (hal_ml_placement_lock);
+  if (ml->placement)
+    numa_node = ml->placement->numa_node;
+  G_UNLOCK (hal_ml_placement_lock);
+
+  return numa_node;
+}
+
+void
+hal_ml_placement_release (hal_ml_s *ml)
+{
+  G_LOCK (hal_ml_placement_lock);
+  if (ml->placement) {
+    hal_ml_placement_release_claims (ml->placement);
+    g_clear_pointer (&ml->placement, g_free);
+  }
+  G_UNLOCK (hal_ml_placement_lock);
+}
+
+int
+hal_ml_set_placement (hal_ml_h handle, const hal_ml_placement_s *placement)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  hal_ml_placement_data_s *data = NULL;
+  hal_ml_placement_data_s *old;
+
+  if (!handle) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (placement) {
+    cpu_set_t node_cpus;
+
+    data = g_new0 (hal_ml_placement_data_s, 1);
+    data->numa_node = placement->numa_node;
+    data->isolated = (placement->isolated != 0);
+
+    if (placement->cpus) {
+      if (!hal_ml_placement_parse_cpus (placement->cpus, &data->cpus)) {
+        _E ("Got invalid CPU list %s", placement->cpus);
+        goto error;
+      }
+    } else if (sched_getaffinity (0, sizeof (cpu_set_t), &data->cpus) != 0) {
+      _E ("Failed to get the CPUs of the process.");
+      goto error;
+    }
+
+    if (data->numa_node != -1) {
+      if (!hal_ml_placement_node_is_valid (data->numa_node)) {
+        _E ("There is no NUMA node %d.", data->numa_node);
+        goto error;
+      }
+
+      /* A memory-only node binds the buffers only. */
+      if (hal_ml_placement_node_cpus (data->numa_node, &node_cpus))
+        CPU_AND (&data->cpus, &data->cpus, &node_cpus);
+    }
+
+    if (CPU_COUNT (&data->cpus) == 0) {
+      _E ("No CPU is left for the placement.");
+      goto error;
+    }
+  }
+
+  G_LOCK (hal_ml_placement_lock);
+  old = ml->placement;
+  if (old)
+    hal_ml_placement_release_claims (old);
+  ml->placement = data;
+  if (data)
+    data->gen = hal_ml_placement_last_gen + 1;
+
+  hal_ml_counter_reset (&ml->placement_invokes);
+  hal_ml_counter_reset (&ml->placement_migrations);
+  hal_ml_counter_reset (&ml->placement_remote_invokes);
+  g_atomic_int_set (&ml->placement_active, data != NULL);
+  g_atomic_int_set (&ml->placement_gen, ++hal_ml_placement_last_gen);
+  G_UNLOCK (hal_ml_placement_lock);
+
+  g_free (old);
+  return HAL_ML_ERROR_NONE;
+
+error:
+  g_free (data);
+  return HAL_ML_ERROR_INVALID_PARAMETER;
+}
+
+int
+hal_ml_get_placement_stats (hal_ml_h handle, hal_ml_placement_stats_s *stats)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+
+  if (!handle || !stats) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  stats->invokes = hal_ml_counter_get (&ml->placement_invokes);
+  stats->migrations = hal_ml_counter_get (&ml->placement_migrations);
+  stats->remote_invokes = hal_ml_counter_get (&ml->placement_remote_invokes);
+  return HAL_ML_ERROR_NONE;
+}
@@ -0,0 +1,217 @@
+/**
+ * Internal definitions of HAL (Hardware Abstract Layer) API for ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-private.h
+ * @date    18 Oct 2026
+ * @brief   Internal definitions of HAL (Hardware Abstract Layer) API for ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ *    This header is shared by the sources of libhal-api-ml and is not installed.
+ */
+
+#ifndef __HAL_API_ML_PRIVATE__
+#define __HAL_API_ML_PRIVATE__
+
+#include <dlog.h>
+#include <glib.h>
+#include "hal-ml-interface.h"
+#include "hal-ml.h"
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "HAL_API_ML"
+#define _D(fmt, args...) SLOGD (fmt, ##args)
+#define _I(fmt, args...) SLOGI (fmt, ##args)
+#define _W(fmt, args...) SLOGW (fmt, ##args)
+#define _E(fmt, args...) SLOGE (fmt, ##args)
+
+/* Alignment of the tensors allocated by HAL ML */
+#define HAL_ML_TENSOR_ALIGN (64)
+#define HAL_ML_TENSOR_ALIGN_UP(x) (((x) + HAL_ML_TENSOR_ALIGN - 1) & ~((gsize) HAL_ML_TENSOR_ALIGN - 1))
+
+/**
+ * @brief Statistics counter, updated without a lock. It is 64-bit even on 32-bit targets, so it does not wrap.
+ */
+typedef guint64 hal_ml_counter_t;
+
+static inline void
+hal_ml_counter_inc (hal_ml_counter_t *counter)
+{
+  __atomic_add_fetch (counter, 1, __ATOMIC_RELAXED);
+}
+
+static inline guint64
+hal_ml_counter_get (hal_ml_counter_t *counter)
+{
+  return __atomic_load_n (counter, __ATOMIC_RELAXED);
+}
+
+static inline void
+hal_ml_counter_reset (hal_ml_counter_t *counter)
+{
+  __atomic_store_n (counter, 0, __ATOMIC_RELAXED);
+}
+
+typedef enum {
+  HAL_ML_INVOKE_JOB_QUEUED = 0,
+  HAL_ML_INVOKE_JOB_RUNNING,
+  HAL_ML_INVOKE_JOB_DONE,
+} hal_ml_invoke_job_state_e;
+
+typedef struct _hal_ml_invoke_job_s {
+  const void *input;
+  void *output;
+  gint64 deadline; /* monotonic time in usec */
+  hal_ml_invoke_job_state_e state;
+  gboolean cancel_requested;
+  int result;
+} hal_ml_invoke_job_s;
+
+typedef struct _hal_ml_client_s hal_ml_client_s;
+typedef struct _hal_ml_placement_data_s hal_ml_placement_data_s;
+
+typedef struct _hal_ml_s {
+  void *backend_private;
+  hal_backend_ml_funcs *funcs;
+  gchar *backend_library_name;
+
+  /* Worker for hal_ml_request_invoke_timeout () and the tiles of hal_ml_request_invoke_tiled () */
+  GMutex lock;
+  GCond cond;
+  GQueue pending;
+  GThread *worker;
+  gboolean stopping;
+  hal_ml_invoke_job_s *running;
+  guint cancel_gen; /* incremented by hal_ml_request_cancel () */
+
+  /* Streaming mode, see hal-api-ml-stream.c */
+  struct _hal_ml_stream_s *stream;
+
+  /* Tensor layouts of the backend, valid if layout_cached is set. Protected by lock. */
+  gboolean layout_cached;
+  hal_ml_tensors_layout_s in_layout;
+  hal_ml_tensors_layout_s out_layout;
+
+  /* Connection to hal-ml daemon, used instead of funcs. See hal-api-ml-client.c */
+  hal_ml_client_s *client;
+
+  /* Placement of the threads invoking this handle, see hal-api-ml-placement.c.
+   * placement_gen is 0 until a placement is set. placement is protected by the placement lock. */
+  gint placement_gen;
+  gint placement_active;
+  hal_ml_placement_data_s *placement;
+  hal_ml_counter_t placement_invokes;
+  hal_ml_counter_t placement_migrations;
+  hal_ml_counter_t placement_remote_invokes;
+} hal_ml_s;
+
+/**
+ * @brief Returns TRUE if @a layout has 1 to HAL_ML_TENSOR_SIZE_LIMIT tensors of non-zero size.
+ */
+gboolean hal_ml_layout_is_valid (const hal_ml_tensors_layout_s *layout);
+
+/**
+ * @brief Returns TRUE if @a a and @a b have the same tensor sizes.
+ */
+gboolean hal_ml_layout_is_equal (const hal_ml_tensors_layout_s *a, const hal_ml_tensors_layout_s *b);
+
+/**
+ * @brief Scans the backends once and gets their library names. Returns the number of backends or a negative error value.
+ */
+int hal_ml_get_backend_library_names (gchar ***names);
+
+/**
+ * @brief Creates a handle with the backend library @a backend_lib_name, given by hal_ml_get_backend_library_names().
+ */
+int hal_ml_create_with_library (const gchar *backend_lib_name, hal_ml_h *handle);
+
+/**
+ * @brief Returns the cancel generation of @a ml, to tell later if hal_ml_request_cancel() was called.
+ */
+guint hal_ml_invoke_get_cancel_gen (hal_ml_s *ml);
+
+/**
+ * @brief Queues @a job to the invoke worker of @a ml, starting the worker if needed.
+ * @return HAL_ML_ERROR_CANCELED without queuing if hal_ml_request_cancel() was called since @a cancel_gen was got.
+ */
+int hal_ml_invoke_submit (hal_ml_s *ml, hal_ml_invoke_job_s *job, guint cancel_gen);
+
+/**
+ * @brief Waits until @a job submitted by hal_ml_invoke_submit() is done and returns its result.
+ */
+int hal_ml_invoke_wait (hal_ml_s *ml, hal_ml_invoke_job_s *job);
+
+/**
+ * @brief Marks the calling thread as a thread of HAL ML, which follows the placement of the handles it invokes.
+ */
+void hal_ml_placement_thread_init (void);
+
+/**
+ * @brief Releases the CPU claimed by the calling thread of HAL ML, before it exits.
+ */
+void hal_ml_placement_thread_exit (void);
+
+/**
+ * @brief Applies the placement of @a ml to the calling thread if needed, before an invoke.
+ */
+void hal_ml_placement_enter (hal_ml_s *ml);
+
+/**
+ * @brief Updates the placement counters of @a ml, after an invoke.
+ */
+void hal_ml_placement_leave (hal_ml_s *ml, const void *input, const void *output);
+
+/**
+ * @brief Returns the NUMA node of the placement of @a ml, or -1.
+ */
+int hal_ml_placement_get_node (hal_ml_s *ml);
+
+/**
+ * @brief Releases the placement of @a ml, when it is destroyed.
+ */
+void hal_ml_placement_release (hal_ml_s *ml);
+
+/**
+ * @brief Returns TRUE if the NUMA node exists.
+ */
+gboolean hal_ml_placement_node_is_valid (int numa_node);
+
+/**
+ * @brief Binds the pages of [@a addr, @a addr + @a size) to the NUMA node.
+ */
+int hal_ml_placement_bind_memory (void *addr, gsize size, int numa_node);
+
+/**
+ * @brief Stops the streaming mode of the handle, if it is running.
+ */
+void hal_ml_stream_release (hal_ml_s *ml);
+
+/**
+ * @brief Connects to the shared instance @a instance_name of hal-ml daemon.
+ */
+int hal_ml_client_connect (const char *instance_name, hal_ml_client_s **client);
+
+/**
+ * @brief Closes the connection to hal-ml daemon.
+ */
+void hal_ml_client_disconnect (hal_ml_client_s *client);
+
+/**
+ * @brief Gets the tensor layouts of the shared instance of hal-ml daemon.
+ */
+void hal_ml_client_get_tensors_layout (hal_ml_client_s *client,
+    hal_ml_tensors_layout_s *in_layout, hal_ml_tensors_layout_s *out_layout);
+
+/**
+ * @brief Invokes the shared instance of hal-ml daemon.
+ */
+int hal_ml_client_invoke (hal_ml_client_s *client, const void *input, void *output);
+
+#endif /* __HAL_API_ML_PRIVATE__ */
@@ -0,0 +1,480 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - daemon server
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-server.c
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - daemon server
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * The process hosting the server owns the configured backend instances, so
+ * the weights are loaded once no matter how many processes use a model. Each
+ * client connection is served by its own thread with its own memfd for the
+ * tensors, and the invokes of all clients of an instance are serialized by
+ * the instance lock, which is the single scheduling point for the device.
+ *
+ * The socket file is only accessible to the user of the daemon, and a client
+ * is accepted only if SO_PEERCRED shows that user or root, so other local
+ * users cannot use or configure the instances.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* memfd_create (), struct ucred */
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "hal-api-ml-ipc.h"
+
+typedef struct _hal_ml_server_instance_s {
+  gchar *name;
+  hal_ml_h handle;
+  GMutex lock; /* serializes the invokes of all clients */
+  hal_ml_tensors_layout_s in_layout;
+  hal_ml_tensors_layout_s out_layout;
+} hal_ml_server_instance_s;
+
+typedef struct _hal_ml_server_s hal_ml_server_s;
+
+typedef struct _hal_ml_server_conn_s {
+  hal_ml_server_s *server;
+  int sock;
+  GThread *thread;
+  gint done;
+
+  hal_ml_server_instance_s *instance;
+  gpointer shm;
+  gsize shm_size;
+  hal_ml_tensor_memory_s input[HAL_ML_TENSOR_SIZE_LIMIT + 1];
+  hal_ml_tensor_memory_s output[HAL_ML_TENSOR_SIZE_LIMIT + 1];
+} hal_ml_server_conn_s;
+
+struct _hal_ml_server_s {
+  gchar *path;
+  int listen_sock;
+  GThread *accept_thread;
+
+  GMutex lock;
+  GHashTable *instances; /* name -> instance, removed only when the server is destroyed */
+  GList *conns;
+  gboolean stopping;
+};
+
+static void
+hal_ml_server_instance_free (gpointer data)
+{
+  hal_ml_server_instance_s *instance = (hal_ml_server_instance_s *) data;
+
+  hal_ml_destroy (instance->handle);
+  g_mutex_clear (&instance->lock);
+  g_free (instance->name);
+  g_free (instance);
+}
+
+static void
+hal_ml_server_conn_free (hal_ml_server_conn_s *conn)
+{
+  if (conn->thread)
+    g_thread_join (conn->thread);
+  if (conn->shm)
+    munmap (conn->shm, conn->shm_size);
+  close (conn->sock);
+  g_free (conn);
+}
+
+/**
+ * @brief Creates the sealed memfd holding the tensors of the connection and maps it.
+ * @return The descriptor to pass to the client, or -1.
+ */
+static int
+hal_ml_server_conn_map (hal_ml_server_conn_s *conn)
+{
+  hal_ml_server_instance_s *instance = conn->instance;
+  int fd;
+
+  conn->shm_size = hal_ml_ipc_shm_size (&instance->in_layout, &instance->out_layout);
+
+  fd = memfd_create ("hal-ml-tensors", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0) {
+    _E ("Failed to create memfd.");
+    return -1;
+  }
+
+  /* A client must not be able to shrink the memory under the backend. */
+  if (ftruncate (fd, conn->shm_size) < 0
+      || fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0) {
+    _E ("Failed to set up memfd.");
+    close (fd);
+    return -1;
+  }
+
+  conn->shm = mmap (NULL, conn->shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (conn->shm == MAP_FAILED) {
+    _E ("Failed to map memfd.");
+    conn->shm = NULL;
+    close (fd);
+    return -1;
+  }
+
+  hal_ml_ipc_map_tensors (conn->shm, &instance->in_layout, &instance->out_layout,
+      conn->input, conn->output);
+  return fd;
+}
+
+static int
+hal_ml_server_conn_open (hal_ml_server_conn_s *conn)
+{
+  hal_ml_server_s *server = conn->server;
+  hal_ml_ipc_header_s header;
+  hal_ml_ipc_create_reply_s reply;
+  gchar name[HAL_ML_IPC_NAME_MAX];
+  int fd, ret;
+
+  if (hal_ml_ipc_recv (conn->sock, &header, name, sizeof (name), NULL) != HAL_ML_ERROR_NONE)
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+
+  if (header.cmd != HAL_ML_IPC_CREATE || header.size == 0 || name[header.size - 1] != '\0') {
+    _E ("Got an invalid request from a client.");
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  g_mutex_lock (&server->lock);
+  conn->instance = (hal_ml_server_instance_s *) g_hash_table_lookup (server->instances, name);
+  g_mutex_unlock (&server->lock);
+
+  if (!conn->instance) {
+    _E ("A client requested unknown instance %s.", name);
+    hal_ml_ipc_send (conn->sock, HAL_ML_IPC_CREATE, HAL_ML_ERROR_INVALID_PARAMETER, NULL, 0, -1);
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  fd = hal_ml_server_conn_map (conn);
+  if (fd < 0) {
+    hal_ml_ipc_send (conn->sock, HAL_ML_IPC_CREATE, HAL_ML_ERROR_OUT_OF_MEMORY, NULL, 0, -1);
+    return HAL_ML_ERROR_OUT_OF_MEMORY;
+  }
+
+  memset (&reply, 0, sizeof (reply));
+  reply.in_layout = conn->instance->in_layout;
+  reply.out_layout = conn->instance->out_layout;
+  reply.shm_size = conn->shm_size;
+
+  ret = hal_ml_ipc_send (conn->sock, HAL_ML_IPC_CREATE, HAL_ML_ERROR_NONE, &reply, sizeof (reply), fd);
+  close (fd);
+  return ret;
+}
+
+static gpointer
+hal_ml_server_conn_thread (gpointer data)
+{
+  hal_ml_server_conn_s *conn = (hal_ml_server_conn_s *) data;
+  hal_ml_ipc_header_s header;
+  int ret;
+
+  hal_ml_placement_thread_init ();
+
+  if (hal_ml_server_conn_open (conn) != HAL_ML_ERROR_NONE)
+    goto done;
+
+  /* Returns when the client closes the socket or the server shuts it down. */
+  while (hal_ml_ipc_recv (conn->sock, &header, NULL, 0, NULL) == HAL_ML_ERROR_NONE) {
+    if (header.cmd != HAL_ML_IPC_INVOKE) {
+      _E ("Got an invalid request from a client.");
+      break;
+    }
+
+    g_mutex_lock (&conn->instance->lock);
+    ret = hal_ml_request_invoke (conn->instance->handle, conn->input, conn->output);
+    g_mutex_unlock (&conn->instance->lock);
+
+    if (hal_ml_ipc_send (conn->sock, HAL_ML_IPC_INVOKE, ret, NULL, 0, -1) != HAL_ML_ERROR_NONE)
+      break;
+  }
+
+done:
+  hal_ml_placement_thread_exit ();
+  g_atomic_int_set (&conn->done, 1);
+  return NULL;
+}
+
+/**
+ * @brief Releases the connections whose client is gone. Call this with server->lock held.
+ */
+static void
+hal_ml_server_reap (hal_ml_server_s *server)
+{
+  GList *l = server->conns;
+
+  while (l) {
+    GList *next = l->next;
+    hal_ml_server_conn_s *conn = (hal_ml_server_conn_s *) l->data;
+
+    if (g_atomic_int_get (&conn->done)) {
+      server->conns = g_list_delete_link (server->conns, l);
+      hal_ml_server_conn_free (conn);
+    }
+    l = next;
+  }
+}
+
+/**
+ * @brief Returns TRUE if the client on @a sock runs as the user of the daemon or root.
+ */
+static gboolean
+hal_ml_server_peer_is_allowed (int sock)
+{
+  struct ucred cred;
+  socklen_t len = sizeof (cred);
+
+  if (getsockopt (sock, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) {
+    _W ("Failed to get the credentials of a client (%d).", errno);
+    return FALSE;
+  }
+
+  if (cred.uid != geteuid () && cred.uid != 0) {
+    _W ("Rejected a client of user %u.", (guint) cred.uid);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gpointer
+hal_ml_server_accept_thread (gpointer data)
+{
+  hal_ml_server_s *server = (hal_ml_server_s *) data;
+  hal_ml_server_conn_s *conn;
+  int sock;
+
+  while (TRUE) {
+    sock = accept4 (server->listen_sock, NULL, NULL, SOCK_CLOEXEC);
+
+    g_mutex_lock (&server->lock);
+    if (server->stopping) {
+      g_mutex_unlock (&server->lock);
+      if (sock >= 0)
+        close (sock);
+      break;
+    }
+
+    if (sock < 0) {
+      g_mutex_unlock (&server->lock);
+      if (errno != EINTR && errno != ECONNABORTED) {
+        _W ("Failed to accept a client (%d).", errno);
+        g_usleep (G_USEC_PER_SEC / 100);
+      }
+      continue;
+    }
+
+    if (!hal_ml_server_peer_is_allowed (sock)) {
+      g_mutex_unlock (&server->lock);
+      close (sock);
+      continue;
+    }
+
+    hal_ml_server_reap (server);
+
+    conn = g_new0 (hal_ml_server_conn_s, 1);
+    conn->server = server;
+    conn->sock = sock;
+    conn->thread = g_thread_try_new ("hal-ml-server", hal_ml_server_conn_thread, conn, NULL);
+    if (conn->thread) {
+      server->conns = g_list_prepend (server->conns, conn);
+    } else {
+      _E ("Failed to create a thread for the client.");
+      hal_ml_server_conn_free (conn);
+    }
+    g_mutex_unlock (&server->lock);
+  }
+
+  return NULL;
+}
+
+int
+hal_ml_server_create (const char *socket_path, hal_ml_server_h *server)
+{
+  hal_ml_server_s *s;
+  struct sockaddr_un addr = { 0 };
+  struct stat st;
+
+  if (!socket_path || !server || strlen (socket_path) >= sizeof (addr.sun_path)) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  /* Only a socket, e.g. left by a previous daemon, is replaced; bind () would fail on it. */
+  if (lstat (socket_path, &st) == 0) {
+    if (!S_ISSOCK (st.st_mode)) {
+      _E ("%s exists and is not a socket.", socket_path);
+      return HAL_ML_ERROR_INVALID_PARAMETER;
+    }
+    unlink (socket_path);
+  }
+
+  addr.sun_family = AF_UNIX;
+  g_strlcpy (addr.sun_path, socket_path, sizeof (addr.sun_path));
+
+  s = g_new0 (hal_ml_server_s, 1);
+  s->listen_sock = socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (s->listen_sock < 0) {
+    _E ("Failed to create a socket.");
+    g_free (s);
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  if (bind (s->listen_sock, (struct sockaddr *) &addr, sizeof (addr)) < 0) {
+    _E ("Failed to bind to %s (%d).", socket_path, errno);
+    close (s->listen_sock);
+    g_free (s);
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  /* Clients cannot connect before listen (), so the mode is restricted in time. */
+  if (chmod (socket_path, S_IRUSR | S_IWUSR) < 0 || listen (s->listen_sock, SOMAXCONN) < 0) {
+    _E ("Failed to listen on %s (%d).", socket_path, errno);
+    close (s->listen_sock);
+    unlink (socket_path);
+    g_free (s);
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  s->path = g_strdup (socket_path);
+  g_mutex_init (&s->lock);
+  s->instances = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, hal_ml_server_instance_free);
+
+  s->accept_thread = g_thread_try_new ("hal-ml-server", hal_ml_server_accept_thread, s, NULL);
+  if (!s->accept_thread) {
+    _E ("Failed to create the server thread.");
+    close (s->listen_sock);
+    unlink (s->path);
+    g_hash_table_destroy (s->instances);
+    g_mutex_clear (&s->lock);
+    g_free (s->path);
+    g_free (s);
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  *server = (hal_ml_server_h) s;
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_server_add_instance (hal_ml_server_h server, const char *name, const char *backend_name,
+    const void *prop, const hal_ml_tensors_layout_s *in_layout,
+    const hal_ml_tensors_layout_s *out_layout)
+{
+  hal_ml_server_s *s = (hal_ml_server_s *) server;
+  hal_ml_server_instance_s *instance;
+  hal_ml_h handle = NULL;
+  hal_ml_param_h param = NULL;
+  gboolean query_layout = (!in_layout && !out_layout);
+  gboolean exists;
+  int ret;
+
+  if (!server || !name || !backend_name || !prop || strlen (name) >= HAL_ML_IPC_NAME_MAX
+      || (!query_layout && (!hal_ml_layout_is_valid (in_layout) || !hal_ml_layout_is_valid (out_layout)))) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&s->lock);
+  exists = g_hash_table_contains (s->instances, name);
+  g_mutex_unlock (&s->lock);
+
+  if (exists) {
+    _E ("Instance %s already exists.", name);
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  ret = hal_ml_create (backend_name, &handle);
+  if (ret != HAL_ML_ERROR_NONE)
+    return ret;
+
+  ret = hal_ml_param_create (&param);
+  if (ret == HAL_ML_ERROR_NONE)
+    ret = hal_ml_param_set (param, "properties", (void *) prop);
+  if (ret == HAL_ML_ERROR_NONE)
+    ret = hal_ml_request (handle, "configure_instance", param);
+  if (param)
+    hal_ml_param_destroy (param);
+
+  if (ret != HAL_ML_ERROR_NONE) {
+    _E ("Failed to configure instance %s (%d).", name, ret);
+    hal_ml_destroy (handle);
+    return ret;
+  }
+
+  instance = g_new0 (hal_ml_server_instance_s, 1);
+  instance->name = g_strdup (name);
+  instance->handle = handle;
+  g_mutex_init (&instance->lock);
+
+  if (query_layout) {
+    ret = hal_ml_get_tensors_layout (handle, &instance->in_layout, &instance->out_layout);
+    if (ret != HAL_ML_ERROR_NONE) {
+      hal_ml_server_instance_free (instance);
+      return ret;
+    }
+  } else {
+    instance->in_layout = *in_layout;
+    instance->out_layout = *out_layout;
+  }
+
+  g_mutex_lock (&s->lock);
+  if (g_hash_table_contains (s->instances, name)) {
+    _E ("Instance %s already exists.", name);
+    ret = HAL_ML_ERROR_INVALID_PARAMETER;
+  } else {
+    g_hash_table_insert (s->instances, instance->name, instance);
+  }
+  g_mutex_unlock (&s->lock);
+
+  if (ret != HAL_ML_ERROR_NONE)
+    hal_ml_server_instance_free (instance);
+
+  return ret;
+}
+
+int
+hal_ml_server_destroy (hal_ml_server_h server)
+{
+  hal_ml_server_s *s = (hal_ml_server_s *) server;
+
+  if (!server) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&s->lock);
+  s->stopping = TRUE;
+  g_mutex_unlock (&s->lock);
+
+  /* Wakes up accept () and the clients blocked in recv (). */
+  shutdown (s->listen_sock, SHUT_RDWR);
+  g_thread_join (s->accept_thread);
+
+  for (GList *l = s->conns; l; l = l->next)
+    shutdown (((hal_ml_server_conn_s *) l->data)->sock, SHUT_RDWR);
+  g_list_free_full (s->conns, (GDestroyNotify) hal_ml_server_conn_free);
+
+  close (s->listen_sock);
+  unlink (s->path);
+  g_hash_table_destroy (s->instances);
+  g_mutex_clear (&s->lock);
+  g_free (s->path);
+  g_free (s);
+
+  return HAL_ML_ERROR_NONE;
+}
@@ -0,0 +1,339 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - streaming mode
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-stream.c
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - streaming mode
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * Frames are queued in a single-producer ring. The producer owns head and
+ * the inference thread takes frames by advancing tail with compare-and-swap.
+ * To drop a stale frame, the producer advances tail the same way, so whoever
+ * wins the swap owns the frame and no lock is taken on the hot path. The
+ * mutex and condition are used only to sleep while the ring is empty (or full
+ * with the blocking policy), and while stop waits for the producers to leave.
+ */
+
+#include "hal-api-ml-private.h"
+
+typedef struct _hal_ml_stream_slot_s {
+  gpointer input;
+  gpointer frame_data;
+} hal_ml_stream_slot_s;
+
+typedef struct _hal_ml_stream_s {
+  hal_ml_s *ml;
+  guint depth;
+  hal_ml_stream_policy_e policy;
+  void *output;
+  hal_ml_stream_cb callback;
+  void *user_data;
+
+  hal_ml_stream_slot_s *slots;
+  guint head; /* written by the producer only */
+  guint tail; /* advanced by the inference thread, or by the producer dropping a frame */
+
+  GMutex lock;
+  GCond cond;
+  gint consumer_waiting;
+  gint producer_waiting;
+  gint running;
+  gint pushing;
+  GThread *thread;
+
+  hal_ml_counter_t pushed;
+  hal_ml_counter_t processed;
+  hal_ml_counter_t dropped;
+} hal_ml_stream_s;
+
+/**
+ * @brief Takes the frame at @a index if nobody else took it. Returns TRUE if taken.
+ */
+static gboolean
+hal_ml_stream_take (hal_ml_stream_s *stream, guint index, hal_ml_stream_slot_s *slot)
+{
+  hal_ml_stream_slot_s *s = &stream->slots[index % stream->depth];
+
+  /* The slot cannot be reused before tail passes index, so a winning swap means this read was intact. */
+  slot->input = g_atomic_pointer_get (&s->input);
+  slot->frame_data = g_atomic_pointer_get (&s->frame_data);
+
+  return g_atomic_int_compare_and_exchange (&stream->tail, index, index + 1);
+}
+
+static gboolean
+hal_ml_stream_pop (hal_ml_stream_s *stream, hal_ml_stream_slot_s *slot)
+{
+  guint tail;
+
+  do {
+    tail = (guint) g_atomic_int_get (&stream->tail);
+    if (tail == (guint) g_atomic_int_get (&stream->head))
+      return FALSE;
+  } while (!hal_ml_stream_take (stream, tail, slot));
+
+  return TRUE;
+}
+
+/**
+ * @brief Drops the oldest queued frame. Returns FALSE if the ring is empty.
+ */
+static gboolean
+hal_ml_stream_drop_oldest (hal_ml_stream_s *stream)
+{
+  hal_ml_stream_slot_s slot;
+
+  if (!hal_ml_stream_pop (stream, &slot))
+    return FALSE;
+
+  hal_ml_counter_inc (&stream->dropped);
+  stream->callback (slot.input, NULL, HAL_ML_ERROR_CANCELED, slot.frame_data,
+      stream->user_data);
+  return TRUE;
+}
+
+static void
+hal_ml_stream_wake (hal_ml_stream_s *stream, gint *waiting)
+{
+  if (g_atomic_int_get (waiting)) {
+    g_mutex_lock (&stream->lock);
+    g_cond_broadcast (&stream->cond);
+    g_mutex_unlock (&stream->lock);
+  }
+}
+
+static gpointer
+hal_ml_stream_thread (gpointer data)
+{
+  hal_ml_stream_s *stream = (hal_ml_stream_s *) data;
+  hal_ml_stream_slot_s slot;
+  int ret;
+
+  hal_ml_placement_thread_init ();
+
+  while (TRUE) {
+    /* After stop, the frames left in the ring are dropped instead of invoked. */
+    if (!g_atomic_int_get (&stream->running))
+      break;
+
+    if (hal_ml_stream_pop (stream, &slot)) {
+      hal_ml_stream_wake (stream, &stream->producer_waiting);
+
+      ret = hal_ml_request_invoke ((hal_ml_h) stream->ml, slot.input, stream->output);
+      hal_ml_counter_inc (&stream->processed);
+      stream->callback (slot.input, stream->output, ret, slot.frame_data,
+          stream->user_data);
+      continue;
+    }
+
+    g_mutex_lock (&stream->lock);
+    g_atomic_int_set (&stream->consumer_waiting, 1);
+    while (g_atomic_int_get (&stream->running)
+        && g_atomic_int_get (&stream->tail) == g_atomic_int_get (&stream->head))
+      g_cond_wait (&stream->cond, &stream->lock);
+    g_atomic_int_set (&stream->consumer_waiting, 0);
+    g_mutex_unlock (&stream->lock);
+  }
+
+  hal_ml_placement_thread_exit ();
+  return NULL;
+}
+
+static void
+hal_ml_stream_free (hal_ml_stream_s *stream)
+{
+  g_mutex_clear (&stream->lock);
+  g_cond_clear (&stream->cond);
+  g_free (stream->slots);
+  g_free (stream);
+}
+
+/**
+ * @brief Stops the inference thread and drops the frames left in the ring.
+ */
+static void
+hal_ml_stream_stop_internal (hal_ml_stream_s *stream)
+{
+  g_mutex_lock (&stream->lock);
+  g_atomic_int_set (&stream->running, 0);
+  g_cond_broadcast (&stream->cond);
+  g_mutex_unlock (&stream->lock);
+
+  g_thread_join (stream->thread);
+  stream->thread = NULL;
+
+  /* A producer may still be in hal_ml_stream_push (); let it leave first. */
+  g_mutex_lock (&stream->lock);
+  while (g_atomic_int_get (&stream->pushing) > 0)
+    g_cond_wait (&stream->cond, &stream->lock);
+  g_mutex_unlock (&stream->lock);
+
+  while (hal_ml_stream_drop_oldest (stream))
+    ;
+}
+
+void
+hal_ml_stream_release (hal_ml_s *ml)
+{
+  if (!ml->stream)
+    return;
+
+  if (ml->stream->thread)
+    hal_ml_stream_stop_internal (ml->stream);
+
+  g_clear_pointer (&ml->stream, hal_ml_stream_free);
+}
+
+int
+hal_ml_stream_start (hal_ml_h handle, unsigned int depth, hal_ml_stream_policy_e policy,
+    void *output, hal_ml_stream_cb callback, void *user_data)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  hal_ml_stream_s *stream;
+
+  if (!handle || !callback || depth == 0) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (policy != HAL_ML_STREAM_POLICY_DROP_OLDEST
+      && policy != HAL_ML_STREAM_POLICY_KEEP_LATEST
+      && policy != HAL_ML_STREAM_POLICY_BLOCK) {
+    _E ("Got invalid stream policy %d", policy);
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (ml->stream && ml->stream->thread) {
+    _E ("The stream is already running");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  /* Counters of the previous stream are reset. */
+  g_clear_pointer (&ml->stream, hal_ml_stream_free);
+
+  stream = g_new0 (hal_ml_stream_s, 1);
+  stream->ml = ml;
+  stream->depth = depth;
+  stream->policy = policy;
+  stream->output = output;
+  stream->callback = callback;
+  stream->user_data = user_data;
+  stream->slots = g_new0 (hal_ml_stream_slot_s, depth);
+  g_mutex_init (&stream->lock);
+  g_cond_init (&stream->cond);
+  stream->running = 1;
+
+  stream->thread = g_thread_try_new ("hal-ml-stream", hal_ml_stream_thread, stream, NULL);
+  if (!stream->thread) {
+    _E ("Failed to create the inference thread.");
+    hal_ml_stream_free (stream);
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  ml->stream = stream;
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_stream_push (hal_ml_h handle, const void *input, void *frame_data)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  hal_ml_stream_s *stream;
+  hal_ml_stream_slot_s *slot;
+  guint head;
+  int ret = HAL_ML_ERROR_NONE;
+
+  if (G_UNLIKELY (!handle || !ml->stream)) {
+    _E ("Got invalid handle or the stream is not started");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  stream = ml->stream;
+  g_atomic_int_inc (&stream->pushing);
+  if (G_UNLIKELY (!g_atomic_int_get (&stream->running))) {
+    _E ("The stream is not running");
+    ret = HAL_ML_ERROR_INVALID_PARAMETER;
+    goto done;
+  }
+
+  head = (guint) g_atomic_int_get (&stream->head);
+
+  if (stream->policy == HAL_ML_STREAM_POLICY_KEEP_LATEST) {
+    while (hal_ml_stream_drop_oldest (stream))
+      ;
+  }
+
+  while (head - (guint) g_atomic_int_get (&stream->tail) >= stream->depth) {
+    if (stream->policy != HAL_ML_STREAM_POLICY_BLOCK) {
+      hal_ml_stream_drop_oldest (stream);
+      continue;
+    }
+
+    g_mutex_lock (&stream->lock);
+    g_atomic_int_set (&stream->producer_waiting, 1);
+    while (g_atomic_int_get (&stream->running)
+        && head - (guint) g_atomic_int_get (&stream->tail) >= stream->depth)
+      g_cond_wait (&stream->cond, &stream->lock);
+    g_atomic_int_set (&stream->producer_waiting, 0);
+    g_mutex_unlock (&stream->lock);
+
+    if (!g_atomic_int_get (&stream->running)) {
+      ret = HAL_ML_ERROR_CANCELED;
+      goto done;
+    }
+  }
+
+  slot = &stream->slots[head % stream->depth];
+  g_atomic_pointer_set (&slot->input, (gpointer) input);
+  g_atomic_pointer_set (&slot->frame_data, frame_data);
+  g_atomic_int_set (&stream->head, head + 1);
+  hal_ml_counter_inc (&stream->pushed);
+
+  hal_ml_stream_wake (stream, &stream->consumer_waiting);
+
+done:
+  /* The last producer leaving wakes up hal_ml_stream_stop (), which waits for it. */
+  if (g_atomic_int_dec_and_test (&stream->pushing) && !g_atomic_int_get (&stream->running)) {
+    g_mutex_lock (&stream->lock);
+    g_cond_broadcast (&stream->cond);
+    g_mutex_unlock (&stream->lock);
+  }
+  return ret;
+}
+
+int
+hal_ml_stream_stop (hal_ml_h handle)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+
+  if (!handle || !ml->stream || !ml->stream->thread) {
+    _E ("Got invalid handle or the stream is not running");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  hal_ml_stream_stop_internal (ml->stream);
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_stream_get_stats (hal_ml_h handle, hal_ml_stream_stats_s *stats)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+
+  if (!handle || !stats || !ml->stream) {
+    _E ("Got invalid parameter or the stream was never started");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  stats->pushed = hal_ml_counter_get (&ml->stream->pushed);
+  stats->processed = hal_ml_counter_get (&ml->stream->processed);
+  stats->dropped = hal_ml_counter_get (&ml->stream->dropped);
+
+  return HAL_ML_ERROR_NONE;
+}
@@ -0,0 +1,303 @@
+/**
+ * HAL (Hardware Abstract Layer) API for ML - tiled invoke
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    hal-api-ml-tile.c
+ * @date    18 Oct 2026
+ * @brief   HAL (Hardware Abstract Layer) API for ML - tiled invoke
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ * hal_ml_request_invoke_tiled () keeps a ring of in_flight slots, each with
+ * the buffers of one tile. The calling thread copies a tile into a free slot
+ * and queues it to the invoke worker of the handle. When the ring is full, it
+ * waits for the oldest slot, copies its output steps into the result and
+ * reuses the slot. So the copies of the next and the previous tiles run while
+ * the backend is busy with the current one.
+ *
+ * A tile covers the steps [core_start, core_end) of the axis. Its window, the
+ * steps the model sees, starts overlap steps before it and is shifted inwards
+ * at the edges of the input, so the windows always have the size the model
+ * was configured for.
+ */
+
+#include <string.h>
+
+#include "hal-api-ml-private.h"
+
+typedef struct _hal_ml_tile_slot_s {
+  hal_ml_invoke_job_s job;
+  hal_ml_tensor_memory_s in[2];
+  hal_ml_tensor_memory_s out[2];
+  void *in_tensors; /* NULL if the window is read from the input directly */
+  void *out_tensors;
+  gsize core_start;
+  gsize core_end;
+  gsize window_start;
+  gboolean busy;
+} hal_ml_tile_slot_s;
+
+typedef struct _hal_ml_tile_s {
+  hal_ml_s *ml;
+  hal_ml_tiling_s tiling;
+  gsize window;
+  guint cancel_gen; /* the cancel generation of the handle when the invoke started */
+  const guint8 *input;
+  guint8 *output;
+  guint num_slots;
+  hal_ml_tile_slot_s *slots;
+} hal_ml_tile_s;
+
+/**
+ * @brief Gets @a a * @a b * @a c, or returns FALSE if it overflows.
+ */
+static gboolean
+hal_ml_tile_mul (gsize a, gsize b, gsize c, gsize *result)
+{
+  if (b != 0 && a > G_MAXSIZE / b)
+    return FALSE;
+  if (c != 0 && a * b > G_MAXSIZE / c)
+    return FALSE;
+
+  *result = a * b * c;
+  return TRUE;
+}
+
+/**
+ * @brief Returns the first tensor of @a tensors if it is the only one and has @a size bytes.
+ */
+static const hal_ml_tensor_memory_s *
+hal_ml_tile_get_tensor (const void *tensors, gsize size)
+{
+  const hal_ml_tensor_memory_s *mem = (const hal_ml_tensor_memory_s *) tensors;
+
+  if (!mem[0].data || mem[0].size != size || mem[1].data)
+    return NULL;
+
+  return mem;
+}
+
+/**
+ * @brief Checks the tensor layout of the handle against a tile. A backend without the layout is trusted.
+ */
+static int
+hal_ml_tile_check_layout (hal_ml_tile_s *t)
+{
+  hal_ml_tensors_layout_s in_layout, out_layout;
+  int ret;
+
+  ret = hal_ml_get_tensors_layout (t->ml, &in_layout, &out_layout);
+  if (ret == HAL_ML_ERROR_NOT_SUPPORTED)
+    return HAL_ML_ERROR_NONE;
+  if (ret != HAL_ML_ERROR_NONE)
+    return ret;
+
+  if (in_layout.num_tensors != 1 || out_layout.num_tensors != 1
+      || in_layout.size[0] != t->tiling.outer * t->window * t->tiling.in_stride
+      || out_layout.size[0] != t->tiling.outer * t->window * t->tiling.out_stride) {
+    _E ("The tensor layout of the instance does not match a tile of %zu steps.", t->window);
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  return HAL_ML_ERROR_NONE;
+}
+
+static int
+hal_ml_tile_alloc_slots (hal_ml_tile_s *t)
+{
+  const hal_ml_tiling_s *tiling = &t->tiling;
+  int numa_node = hal_ml_placement_get_node (t->ml);
+  hal_ml_tensors_layout_s in_layout = { 1, { tiling->outer * t->window * tiling->in_stride } };
+  hal_ml_tensors_layout_s out_layout = { 1, { tiling->outer * t->window * tiling->out_stride } };
+  int ret = HAL_ML_ERROR_NONE;
+
+  t->slots = g_new0 (hal_ml_tile_slot_s, t->num_slots);
+
+  for (guint i = 0; i < t->num_slots; i++) {
+    hal_ml_tile_slot_s *slot = &t->slots[i];
+
+    /* A single slice of the axis is contiguous in the input, so its windows need no copy. */
+    if (tiling->outer > 1) {
+      ret = hal_ml_tensors_alloc_on_node (&in_layout, numa_node, &slot->in_tensors);
+      if (ret != HAL_ML_ERROR_NONE)
+        break;
+    }
+
+    ret = hal_ml_tensors_alloc_on_node (&out_layout, numa_node, &slot->out_tensors);
+    if (ret != HAL_ML_ERROR_NONE)
+      break;
+
+    slot->in[0].size = in_layout.size[0];
+    slot->out[0].size = out_layout.size[0];
+    slot->job.input = slot->in;
+    slot->job.output = slot->out;
+    slot->job.deadline = G_MAXINT64;
+  }
+
+  return ret;
+}
+
+static void
+hal_ml_tile_free_slots (hal_ml_tile_s *t)
+{
+  if (!t->slots)
+    return;
+
+  for (guint i = 0; i < t->num_slots; i++) {
+    hal_ml_tensors_free (t->slots[i].in_tensors);
+    hal_ml_tensors_free (t->slots[i].out_tensors);
+  }
+
+  g_free (t->slots);
+}
+
+/**
+ * @brief Fills @a slot with the window of the tile @a index.
+ */
+static void
+hal_ml_tile_gather (hal_ml_tile_s *t, hal_ml_tile_slot_s *slot, gsize index)
+{
+  const hal_ml_tiling_s *tiling = &t->tiling;
+  gsize window_bytes = t->window * tiling->in_stride;
+
+  slot->core_start = index * tiling->tile;
+  slot->core_end = MIN (slot->core_start + tiling->tile, tiling->length);
+  slot->window_start = (slot->core_start > tiling->overlap) ? slot->core_start - tiling->overlap : 0;
+  slot->window_start = MIN (slot->window_start, tiling->length - t->window);
+
+  if (!slot->in_tensors) {
+    slot->in[0].data = (void *) (t->input + slot->window_start * tiling->in_stride);
+  } else {
+    hal_ml_tensor_memory_s *mem = (hal_ml_tensor_memory_s *) slot->in_tensors;
+
+    for (gsize o = 0; o < tiling->outer; o++)
+      memcpy ((guint8 *) mem[0].data + o * window_bytes,
+          t->input + (o * tiling->length + slot->window_start) * tiling->in_stride, window_bytes);
+    slot->in[0].data = mem[0].data;
+  }
+
+  /* A whole window without overlap is the result itself, so let the backend write it in place. */
+  if (tiling->outer == 1 && slot->window_start == slot->core_start
+      && slot->core_end - slot->core_start == t->window)
+    slot->out[0].data = t->output + slot->core_start * tiling->out_stride;
+  else
+    slot->out[0].data = ((hal_ml_tensor_memory_s *) slot->out_tensors)[0].data;
+}
+
+/**
+ * @brief Copies the output steps of the tile in @a slot to the result.
+ */
+static void
+hal_ml_tile_scatter (hal_ml_tile_s *t, hal_ml_tile_slot_s *slot)
+{
+  const hal_ml_tiling_s *tiling = &t->tiling;
+  const guint8 *tile_out = (const guint8 *) slot->out[0].data;
+  gsize core_bytes = (slot->core_end - slot->core_start) * tiling->out_stride;
+  gsize skip = slot->core_start - slot->window_start;
+
+  if (tile_out == t->output + slot->core_start * tiling->out_stride)
+    return;
+
+  for (gsize o = 0; o < tiling->outer; o++)
+    memcpy (t->output + (o * tiling->length + slot->core_start) * tiling->out_stride,
+        tile_out + (o * t->window + skip) * tiling->out_stride, core_bytes);
+}
+
+/**
+ * @brief Waits for the tile in @a slot and stitches it if every tile so far succeeded.
+ */
+static int
+hal_ml_tile_complete (hal_ml_tile_s *t, hal_ml_tile_slot_s *slot, int ret)
+{
+  int result;
+
+  if (!slot->busy)
+    return ret;
+
+  result = hal_ml_invoke_wait (t->ml, &slot->job);
+  slot->busy = FALSE;
+
+  if (ret != HAL_ML_ERROR_NONE)
+    return ret;
+
+  if (result == HAL_ML_ERROR_NONE)
+    hal_ml_tile_scatter (t, slot);
+
+  return result;
+}
+
+int
+hal_ml_request_invoke_tiled (hal_ml_h handle, const hal_ml_tiling_s *tiling, const void *input, void *output)
+{
+  hal_ml_tile_s t = { 0 };
+  const hal_ml_tensor_memory_s *in_mem, *out_mem;
+  gsize in_size, out_size, num_tiles;
+  int ret;
+
+  if (G_UNLIKELY (!handle || !tiling || !input || !output)) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (tiling->outer == 0 || tiling->length == 0 || tiling->in_stride == 0
+      || tiling->out_stride == 0 || tiling->tile == 0 || tiling->in_flight == 0
+      || tiling->overlap > (G_MAXSIZE - tiling->tile) / 2
+      || tiling->tile + 2 * tiling->overlap > tiling->length) {
+    _E ("Got invalid tiling: %zu steps, tile %zu, overlap %zu, in flight %u",
+        tiling->length, tiling->tile, tiling->overlap, tiling->in_flight);
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (!hal_ml_tile_mul (tiling->outer, tiling->length, tiling->in_stride, &in_size)
+      || !hal_ml_tile_mul (tiling->outer, tiling->length, tiling->out_stride, &out_size)) {
+    _E ("The size of the tiled tensors overflows.");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  in_mem = hal_ml_tile_get_tensor (input, in_size);
+  out_mem = hal_ml_tile_get_tensor (output, out_size);
+  if (!in_mem || !out_mem) {
+    _E ("The input and output should be a single tensor of %zu and %zu bytes.", in_size, out_size);
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  t.ml = (hal_ml_s *) handle;
+  t.cancel_gen = hal_ml_invoke_get_cancel_gen (t.ml);
+  t.tiling = *tiling;
+  t.window = tiling->tile + 2 * tiling->overlap;
+  t.input = (const guint8 *) in_mem[0].data;
+  t.output = (guint8 *) out_mem[0].data;
+
+  ret = hal_ml_tile_check_layout (&t);
+  if (ret != HAL_ML_ERROR_NONE)
+    return ret;
+
+  num_tiles = (tiling->length + tiling->tile - 1) / tiling->tile;
+  t.num_slots = (guint) MIN ((gsize) tiling->in_flight, num_tiles);
+
+  ret = hal_ml_tile_alloc_slots (&t);
+
+  for (gsize i = 0; ret == HAL_ML_ERROR_NONE && i < num_tiles; i++) {
+    hal_ml_tile_slot_s *slot = &t.slots[i % t.num_slots];
+
+    /* The slot to reuse holds the oldest tile. */
+    ret = hal_ml_tile_complete (&t, slot, ret);
+    if (ret != HAL_ML_ERROR_NONE)
+      break;
+
+    hal_ml_tile_gather (&t, slot, i);
+    ret = hal_ml_invoke_submit (t.ml, &slot->job, t.cancel_gen);
+    slot->busy = (ret == HAL_ML_ERROR_NONE);
+  }
+
+  /* The backend may still use the buffers of the queued tiles, even after a failure. */
+  for (guint i = 0; t.slots && i < t.num_slots; i++)
+    ret = hal_ml_tile_complete (&t, &t.slots[i], ret);
+
+  hal_ml_tile_free_slots (&t);
+  return ret;
+}
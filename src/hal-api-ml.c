@@ -17,26 +17,12 @@
  * tensor_filter subplugin) to use hardware acceleration devices (NPU, ...).
  */
 
-#include <dlog.h>
-#include <glib.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <hal/hal-common.h>
-#include "hal-ml-interface.h"
-#include "hal-ml.h"
-
-#ifdef LOG_TAG
-#undef LOG_TAG
-#endif
-#define LOG_TAG "HAL_API_ML"
-#define _D(fmt, args...) SLOGD (fmt, ##args)
-#define _I(fmt, args...) SLOGI (fmt, ##args)
-#define _W(fmt, args...) SLOGW (fmt, ##args)
-#define _E(fmt, args...) SLOGE (fmt, ##args)
-
-typedef struct _hal_ml_s {
-  void *backend_private;
-  hal_backend_ml_funcs *funcs;
-  gchar *backend_library_name;
-} hal_ml_s;
+#include "hal-api-ml-private.h"
+
 
 typedef struct _hal_ml_param_s {
   GHashTable *table;
@@ -64,6 +50,9 @@ static int hal_ml_backend_count = 0;
 static gchar **hal_ml_backend_names = NULL;
 static GHashTable *hal_ml_cached_backends = NULL;
 G_LOCK_DEFINE_STATIC (hal_ml_cached_backends_lock);
+static gint hal_ml_backends_scanned = 0;
+static int hal_ml_scan_result = 0;
+G_LOCK_DEFINE_STATIC (hal_ml_scan_lock);
 
 /**
  * @brief Destructor to clean up global resources when the library is unloaded.
@@ -207,9 +196,332 @@ hal_ml_param_get (hal_ml_param_h param, const char *key, void **value)
   return HAL_ML_ERROR_NONE;
 }
 
+gboolean
+hal_ml_layout_is_valid (const hal_ml_tensors_layout_s *layout)
+{
+  if (!layout || layout->num_tensors == 0 || layout->num_tensors > HAL_ML_TENSOR_SIZE_LIMIT)
+    return FALSE;
+
+  for (guint i = 0; i < layout->num_tensors; i++) {
+    if (layout->size[i] == 0)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+gboolean
+hal_ml_layout_is_equal (const hal_ml_tensors_layout_s *a, const hal_ml_tensors_layout_s *b)
+{
+  if (a->num_tensors != b->num_tensors)
+    return FALSE;
+
+  for (guint i = 0; i < a->num_tensors; i++) {
+    if (a->size[i] != b->size[i])
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static inline int
+hal_ml_invoke_backend (hal_ml_s *ml, const void *input, void *output)
+{
+  if (ml->client)
+    return hal_ml_client_invoke (ml->client, input, output);
+
+  return ml->funcs->invoke (ml->backend_private, input, output);
+}
+
+static int
+hal_ml_invoke_internal (hal_ml_s *ml, const void *input, void *output)
+{
+  int ret;
+
+  /* Without a placement, this costs one atomic read. */
+  if (G_LIKELY (!g_atomic_int_get (&ml->placement_gen)))
+    return hal_ml_invoke_backend (ml, input, output);
+
+  hal_ml_placement_enter (ml);
+  ret = hal_ml_invoke_backend (ml, input, output);
+  hal_ml_placement_leave (ml, input, output);
+  return ret;
+}
+
+/**
+ * @brief Completes the queued jobs with the given result. Call this with ml->lock held.
+ */
+static void
+hal_ml_flush_pending (hal_ml_s *ml, int result)
+{
+  hal_ml_invoke_job_s *job;
+
+  while ((job = (hal_ml_invoke_job_s *) g_queue_pop_head (&ml->pending))) {
+    job->result = result;
+    job->state = HAL_ML_INVOKE_JOB_DONE;
+  }
+
+  g_cond_broadcast (&ml->cond);
+}
+
+static gpointer
+hal_ml_invoke_worker (gpointer data)
+{
+  hal_ml_s *ml = (hal_ml_s *) data;
+  hal_ml_invoke_job_s *job;
+  int ret;
+
+  hal_ml_placement_thread_init ();
+
+  g_mutex_lock (&ml->lock);
+  while (!ml->stopping) {
+    job = (hal_ml_invoke_job_s *) g_queue_pop_head (&ml->pending);
+    if (!job) {
+      g_cond_wait (&ml->cond, &ml->lock);
+      continue;
+    }
+
+    /* Do not spend device time on a request which cannot meet its deadline. */
+    if (g_get_monotonic_time () >= job->deadline) {
+      job->result = HAL_ML_ERROR_TIMED_OUT;
+      job->state = HAL_ML_INVOKE_JOB_DONE;
+      g_cond_broadcast (&ml->cond);
+      continue;
+    }
+
+    job->state = HAL_ML_INVOKE_JOB_RUNNING;
+    ml->running = job;
+    g_mutex_unlock (&ml->lock);
+
+    ret = hal_ml_invoke_internal (ml, job->input, job->output);
+
+    g_mutex_lock (&ml->lock);
+    ml->running = NULL;
+    if (ret != HAL_ML_ERROR_NONE && job->cancel_requested)
+      ret = HAL_ML_ERROR_CANCELED;
+    job->result = ret;
+    job->state = HAL_ML_INVOKE_JOB_DONE;
+    g_cond_broadcast (&ml->cond);
+  }
+  g_mutex_unlock (&ml->lock);
+
+  hal_ml_placement_thread_exit ();
+  return NULL;
+}
+
+/**
+ * @brief Starts the invoke worker if it is not running. Call this with ml->lock held.
+ */
+static int
+hal_ml_start_worker (hal_ml_s *ml)
+{
+  if (ml->worker)
+    return HAL_ML_ERROR_NONE;
+
+  ml->stopping = FALSE;
+  ml->worker = g_thread_try_new ("hal-ml-invoke", hal_ml_invoke_worker, ml, NULL);
+  if (!ml->worker) {
+    _E ("Failed to create the invoke worker thread.");
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  return HAL_ML_ERROR_NONE;
+}
+
+/**
+ * @brief Queues @a job to the invoke worker. Call this with ml->lock held.
+ */
+static int
+hal_ml_queue_job (hal_ml_s *ml, hal_ml_invoke_job_s *job)
+{
+  int ret = hal_ml_start_worker (ml);
+
+  if (ret != HAL_ML_ERROR_NONE)
+    return ret;
+
+  job->state = HAL_ML_INVOKE_JOB_QUEUED;
+  job->cancel_requested = FALSE;
+  g_queue_push_tail (&ml->pending, job);
+  g_cond_broadcast (&ml->cond);
+
+  return HAL_ML_ERROR_NONE;
+}
+
+guint
+hal_ml_invoke_get_cancel_gen (hal_ml_s *ml)
+{
+  guint cancel_gen;
+
+  g_mutex_lock (&ml->lock);
+  cancel_gen = ml->cancel_gen;
+  g_mutex_unlock (&ml->lock);
+
+  return cancel_gen;
+}
+
+int
+hal_ml_invoke_submit (hal_ml_s *ml, hal_ml_invoke_job_s *job, guint cancel_gen)
+{
+  int ret;
+
+  g_mutex_lock (&ml->lock);
+  /* A cancel which came while no job was queued still stops the caller's next ones. */
+  if (ml->cancel_gen != cancel_gen)
+    ret = HAL_ML_ERROR_CANCELED;
+  else
+    ret = hal_ml_queue_job (ml, job);
+  g_mutex_unlock (&ml->lock);
+
+  return ret;
+}
+
+int
+hal_ml_invoke_wait (hal_ml_s *ml, hal_ml_invoke_job_s *job)
+{
+  g_mutex_lock (&ml->lock);
+  while (job->state != HAL_ML_INVOKE_JOB_DONE)
+    g_cond_wait (&ml->cond, &ml->lock);
+  g_mutex_unlock (&ml->lock);
+
+  return job->result;
+}
+
+static void
+hal_ml_stop_worker (hal_ml_s *ml)
+{
+  GThread *worker;
+
+  g_mutex_lock (&ml->lock);
+  worker = ml->worker;
+  ml->worker = NULL;
+  ml->stopping = TRUE;
+  hal_ml_flush_pending (ml, HAL_ML_ERROR_CANCELED);
+  g_mutex_unlock (&ml->lock);
+
+  if (worker)
+    g_thread_join (worker);
+}
+
+static void
+hal_ml_init_handle (hal_ml_s *ml)
+{
+  g_mutex_init (&ml->lock);
+  g_cond_init (&ml->cond);
+  g_queue_init (&ml->pending);
+}
+
+/**
+ * @brief Creates a handle forwarding to the shared instance @a instance_name of hal-ml daemon.
+ */
+static int
+hal_ml_create_remote (const char *instance_name, hal_ml_h *handle)
+{
+  hal_ml_client_s *client = NULL;
+  hal_ml_s *ml;
+  int ret;
+
+  _I ("Connecting to instance %s of hal-ml daemon", instance_name);
+
+  ret = hal_ml_client_connect (instance_name, &client);
+  if (ret != HAL_ML_ERROR_NONE)
+    return ret;
+
+  ml = g_new0 (hal_ml_s, 1);
+  ml->client = client;
+  ml->backend_library_name = g_strconcat (HAL_ML_DAEMON_PREFIX, instance_name, NULL);
+  hal_ml_init_handle (ml);
+  *handle = (hal_ml_h) ml;
+
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_get_backend_library_names (gchar ***names)
+{
+  /* Scan backend only once, even if several threads create handles at once */
+  if (!g_atomic_int_get (&hal_ml_backends_scanned)) {
+    G_LOCK (hal_ml_scan_lock);
+    if (!g_atomic_int_get (&hal_ml_backends_scanned)) {
+      hal_ml_scan_result = hal_ml_scan_backends ();
+      g_atomic_int_set (&hal_ml_backends_scanned, 1);
+    }
+    G_UNLOCK (hal_ml_scan_lock);
+  }
+
+  if (hal_ml_scan_result < 0) {
+    _E ("Failed to scan backends");
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  *names = hal_ml_backend_names;
+  return hal_ml_backend_count;
+}
+
+int
+hal_ml_create_with_library (const gchar *backend_lib_name, hal_ml_h *handle)
+{
+  G_LOCK (hal_ml_cached_backends_lock);
+  if (!hal_ml_cached_backends) {
+    hal_ml_cached_backends
+        = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  }
+
+  if (!g_hash_table_lookup (hal_ml_cached_backends, backend_lib_name)) {
+    hal_backend_ml_funcs *cached_funcs = NULL;
+    int ret = hal_common_get_backend_with_library_name_v2 (HAL_MODULE_ML,
+        (void **) &cached_funcs, NULL, hal_ml_create_backend,
+        backend_lib_name);
+
+    if (ret == 0 && cached_funcs) {
+      _I ("Backend %s cached.", backend_lib_name);
+      g_hash_table_insert (hal_ml_cached_backends,
+          g_strdup (backend_lib_name), cached_funcs);
+    } else {
+      _W ("Failed to cache backend %s", backend_lib_name);
+    }
+  }
+  G_UNLOCK (hal_ml_cached_backends_lock);
+
+  hal_ml_s *new_handle = g_new0 (hal_ml_s, 1);
+  if (!new_handle) {
+    return HAL_ML_ERROR_OUT_OF_MEMORY;
+  }
+
+  /* Fill function pointers from backend */
+  int ret = hal_common_get_backend_with_library_name_v2 (HAL_MODULE_ML,
+      (void **) &new_handle->funcs, NULL, hal_ml_create_backend,
+      backend_lib_name);
+
+  if (ret != 0 || !new_handle->funcs || !new_handle->funcs->init) {
+    _E ("Failed to get backend");
+    g_free (new_handle);
+    return HAL_ML_ERROR_RUNTIME_ERROR;
+  }
+
+  /* Initialize backend */
+  ret = new_handle->funcs->init (&new_handle->backend_private);
+  if (ret != HAL_ML_ERROR_NONE) {
+    _E ("Failed to initialize backend.");
+    hal_common_put_backend_with_library_name_v2 (HAL_MODULE_ML,
+        (void *) new_handle->funcs, NULL, hal_ml_exit_backend,
+        backend_lib_name);
+    g_free (new_handle);
+    return ret;
+  }
+
+  _I ("Backend initialized successfully with %s", backend_lib_name);
+  new_handle->backend_library_name = g_strdup (backend_lib_name);
+  hal_ml_init_handle (new_handle);
+  *handle = (hal_ml_h) new_handle;
+  return HAL_ML_ERROR_NONE;
+}
+
 int
 hal_ml_create (const char *backend_name, hal_ml_h *handle)
 {
+  gchar **names;
+  int count;
+
   if (!handle) {
     _E ("Got invalid handle");
     return HAL_ML_ERROR_INVALID_PARAMETER;
@@ -220,17 +532,14 @@ hal_ml_create (const char *backend_name, hal_ml_h *handle)
     return HAL_ML_ERROR_INVALID_PARAMETER;
   }
 
-  /* Scan backend only once */
-  static int scanned = 1;
-  if (scanned == 1) {
-    scanned = hal_ml_scan_backends ();
-    if (scanned < 0) {
-      _E ("Failed to scan backends");
-      return HAL_ML_ERROR_RUNTIME_ERROR;
-    }
-  }
+  if (g_str_has_prefix (backend_name, HAL_ML_DAEMON_PREFIX))
+    return hal_ml_create_remote (backend_name + strlen (HAL_ML_DAEMON_PREFIX), handle);
 
-  if (hal_ml_backend_count == 0) {
+  count = hal_ml_get_backend_library_names (&names);
+  if (count < 0)
+    return count;
+
+  if (count == 0) {
     _E ("There is no available backends");
     return HAL_ML_ERROR_NOT_SUPPORTED;
   }
@@ -238,64 +547,9 @@ hal_ml_create (const char *backend_name, hal_ml_h *handle)
   _I ("Initializing backend %s", backend_name);
 
   /* Find matched backend */
-  for (int i = 0; i < hal_ml_backend_count; i++) {
-    if (g_strrstr (hal_ml_backend_names[i], backend_name) != NULL) {
-      gchar *backend_lib_name = hal_ml_backend_names[i];
-
-      G_LOCK (hal_ml_cached_backends_lock);
-      if (!hal_ml_cached_backends) {
-        hal_ml_cached_backends
-            = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
-      }
-
-      if (!g_hash_table_lookup (hal_ml_cached_backends, backend_lib_name)) {
-        hal_backend_ml_funcs *cached_funcs = NULL;
-        int ret = hal_common_get_backend_with_library_name_v2 (HAL_MODULE_ML,
-            (void **) &cached_funcs, NULL, hal_ml_create_backend,
-            backend_lib_name);
-
-        if (ret == 0 && cached_funcs) {
-          _I ("Backend %s cached.", backend_lib_name);
-          g_hash_table_insert (hal_ml_cached_backends,
-              g_strdup (backend_lib_name), cached_funcs);
-        } else {
-          _W ("Failed to cache backend %s", backend_lib_name);
-        }
-      }
-      G_UNLOCK (hal_ml_cached_backends_lock);
-
-      hal_ml_s *new_handle = g_new0 (hal_ml_s, 1);
-      if (!new_handle) {
-        return HAL_ML_ERROR_OUT_OF_MEMORY;
-      }
-
-      /* Fill function pointers from backend */
-      int ret = hal_common_get_backend_with_library_name_v2 (HAL_MODULE_ML,
-          (void **) &new_handle->funcs, NULL, hal_ml_create_backend,
-          backend_lib_name);
-
-      if (ret != 0 || !new_handle->funcs || !new_handle->funcs->init) {
-        _E ("Failed to get backend");
-        g_free (new_handle);
-        return HAL_ML_ERROR_RUNTIME_ERROR;
-      }
-
-      /* Initialize backend */
-      ret = new_handle->funcs->init (&new_handle->backend_private);
-      if (ret != HAL_ML_ERROR_NONE) {
-        _E ("Failed to initialize backend.");
-        hal_common_put_backend_with_library_name_v2 (HAL_MODULE_ML,
-            (void *) new_handle->funcs, NULL, hal_ml_exit_backend,
-            backend_lib_name);
-        g_free (new_handle);
-        return ret;
-      }
-
-      _I ("Backend initialized successfully with %s", backend_lib_name);
-      new_handle->backend_library_name = g_strdup (backend_lib_name);
-      *handle = (hal_ml_h) new_handle;
-      return HAL_ML_ERROR_NONE;
-    }
+  for (int i = 0; i < count; i++) {
+    if (g_strrstr (names[i], backend_name) != NULL)
+      return hal_ml_create_with_library (names[i], handle);
   }
 
   _E ("No backend matched with %s", backend_name);
@@ -314,6 +568,19 @@ hal_ml_destroy (hal_ml_h handle)
 
   _I ("Deinitializing backend %s", ml->backend_library_name);
 
+  hal_ml_stream_release (ml);
+  hal_ml_stop_worker (ml);
+  hal_ml_placement_release (ml);
+
+  if (ml->client) {
+    hal_ml_client_disconnect (ml->client);
+    g_mutex_clear (&ml->lock);
+    g_cond_clear (&ml->cond);
+    g_free (ml->backend_library_name);
+    g_free (ml);
+    return HAL_ML_ERROR_NONE;
+  }
+
   int ret = ml->funcs->deinit (ml->backend_private);
   if (ret != HAL_ML_ERROR_NONE) {
     _W ("Failed to deinitialize backend.");
@@ -322,6 +589,8 @@ hal_ml_destroy (hal_ml_h handle)
   ret = hal_common_put_backend_with_library_name_v2 (HAL_MODULE_ML,
       (void *) ml->funcs, NULL, hal_ml_exit_backend, ml->backend_library_name);
 
+  g_mutex_clear (&ml->lock);
+  g_cond_clear (&ml->cond);
   g_free (ml->backend_library_name);
   g_free (ml);
 
@@ -332,10 +601,23 @@ hal_ml_destroy (hal_ml_h handle)
   return HAL_ML_ERROR_NONE;
 }
 
+int
+hal_ml_get_backend_name (hal_ml_h handle, const char **backend_name)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+
+  if (!handle || !backend_name) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  *backend_name = ml->backend_library_name;
+  return HAL_ML_ERROR_NONE;
+}
+
 static int
 _hal_ml_configure_instance (hal_ml_h handle, hal_ml_param_h param)
 {
-  hal_ml_s *ml = (hal_ml_s *) handle;
   const void *prop = NULL;
   int ret;
 
@@ -345,13 +627,12 @@ _hal_ml_configure_instance (hal_ml_h handle, hal_ml_param_h param)
     return ret;
   }
 
-  return ml->funcs->configure_instance (ml->backend_private, prop);
+  return hal_ml_request_configure_instance (handle, prop);
 }
 
 static int
 _hal_ml_invoke (hal_ml_h handle, hal_ml_param_h param)
 {
-  hal_ml_s *ml = (hal_ml_s *) handle;
   const void *input = NULL;
   void *output = NULL;
   int ret;
@@ -368,13 +649,12 @@ _hal_ml_invoke (hal_ml_h handle, hal_ml_param_h param)
     return ret;
   }
 
-  return ml->funcs->invoke (ml->backend_private, input, output);
+  return hal_ml_request_invoke (handle, input, output);
 }
 
 static int
 _hal_ml_invoke_dynamic (hal_ml_h handle, hal_ml_param_h param)
 {
-  hal_ml_s *ml = (hal_ml_s *) handle;
   void *prop = NULL;
   const void *input = NULL;
   void *output = NULL;
@@ -398,13 +678,12 @@ _hal_ml_invoke_dynamic (hal_ml_h handle, hal_ml_param_h param)
     return ret;
   }
 
-  return ml->funcs->invoke_dynamic (ml->backend_private, prop, input, output);
+  return hal_ml_request_invoke_dynamic (handle, prop, input, output);
 }
 
 static int
 _hal_ml_get_framework_info (hal_ml_h handle, hal_ml_param_h param)
 {
-  hal_ml_s *ml = (hal_ml_s *) handle;
   void *framework_info = NULL;
   int ret;
 
@@ -414,13 +693,12 @@ _hal_ml_get_framework_info (hal_ml_h handle, hal_ml_param_h param)
     return ret;
   }
 
-  return ml->funcs->get_framework_info (ml->backend_private, framework_info);
+  return hal_ml_request_get_framework_info (handle, framework_info);
 }
 
 static int
 _hal_ml_get_model_info (hal_ml_h handle, hal_ml_param_h param)
 {
-  hal_ml_s *ml = (hal_ml_s *) handle;
   int *model_info_ops = NULL;
   void *in_info = NULL;
   void *out_info = NULL;
@@ -444,13 +722,12 @@ _hal_ml_get_model_info (hal_ml_h handle, hal_ml_param_h param)
     return ret;
   }
 
-  return ml->funcs->get_model_info (ml->backend_private, *model_info_ops, in_info, out_info);
+  return hal_ml_request_get_model_info (handle, *model_info_ops, in_info, out_info);
 }
 
 static int
 _hal_ml_event_handler (hal_ml_h handle, hal_ml_param_h param)
 {
-  hal_ml_s *ml = (hal_ml_s *) handle;
   int *event_ops = NULL;
   void *data = NULL;
   int ret;
@@ -467,7 +744,7 @@ _hal_ml_event_handler (hal_ml_h handle, hal_ml_param_h param)
     return ret;
   }
 
-  return ml->funcs->event_handler (ml->backend_private, *event_ops, data);
+  return hal_ml_request_event_handler (handle, *event_ops, data);
 }
 
 int
@@ -509,5 +786,378 @@ hal_ml_request_invoke (hal_ml_h handle, const void *input, void *output)
     return HAL_ML_ERROR_INVALID_PARAMETER;
   }
 
-  return ml->funcs->invoke (ml->backend_private, input, output);
+  return hal_ml_invoke_internal (ml, input, output);
+}
+
+static void
+hal_ml_invalidate_layout (hal_ml_s *ml)
+{
+  g_mutex_lock (&ml->lock);
+  ml->layout_cached = FALSE;
+  g_mutex_unlock (&ml->lock);
+}
+
+/**
+ * @brief Checks the cached layout against the backend and drops it only if the shape changed.
+ */
+static void
+hal_ml_refresh_layout (hal_ml_s *ml)
+{
+  hal_ml_tensors_layout_s in_layout, out_layout;
+
+  g_mutex_lock (&ml->lock);
+  if (ml->layout_cached) {
+    if (!ml->funcs->get_tensors_layout
+        || ml->funcs->get_tensors_layout (ml->backend_private, &in_layout, &out_layout) != HAL_ML_ERROR_NONE
+        || !hal_ml_layout_is_equal (&in_layout, &ml->in_layout)
+        || !hal_ml_layout_is_equal (&out_layout, &ml->out_layout))
+      ml->layout_cached = FALSE;
+  }
+  g_mutex_unlock (&ml->lock);
+}
+
+/**
+ * @brief Returns NOT_SUPPORTED for a request which cannot be forwarded to hal-ml daemon.
+ * @details Backend structures in the request cannot cross the process boundary.
+ */
+static int
+hal_ml_remote_not_supported (hal_ml_s *ml, const char *request_name)
+{
+  _E ("Request %s is not supported by %s.", request_name, ml->backend_library_name);
+  return HAL_ML_ERROR_NOT_SUPPORTED;
+}
+
+int
+hal_ml_request_configure_instance (hal_ml_h handle, const void *prop)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  if (G_UNLIKELY (!handle)) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  /* The daemon configured the shared instance. */
+  if (ml->client) {
+    _I ("%s is configured by hal-ml daemon, ignoring configure_instance.",
+        ml->backend_library_name);
+    return HAL_ML_ERROR_NONE;
+  }
+
+  int ret;
+
+  /* A layout queried while the backend reconfigures may be either one, so drop it after the call too. */
+  hal_ml_invalidate_layout (ml);
+  ret = ml->funcs->configure_instance (ml->backend_private, prop);
+  hal_ml_invalidate_layout (ml);
+
+  return ret;
+}
+
+int
+hal_ml_request_invoke_dynamic (hal_ml_h handle, void *prop, const void *input, void *output)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  if (G_UNLIKELY (!handle)) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (ml->client)
+    return hal_ml_remote_not_supported (ml, "invoke_dynamic");
+
+  int ret;
+
+  ret = ml->funcs->invoke_dynamic (ml->backend_private, prop, input, output);
+  /* The shape may change with the input. */
+  hal_ml_refresh_layout (ml);
+
+  return ret;
+}
+
+int
+hal_ml_request_get_framework_info (hal_ml_h handle, void *framework_info)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  if (G_UNLIKELY (!handle)) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (ml->client)
+    return hal_ml_remote_not_supported (ml, "get_framework_info");
+
+  return ml->funcs->get_framework_info (ml->backend_private, framework_info);
+}
+
+int
+hal_ml_request_get_model_info (hal_ml_h handle, int ops, void *in_info, void *out_info)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  if (G_UNLIKELY (!handle)) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (ml->client)
+    return hal_ml_remote_not_supported (ml, "get_model_info");
+
+  return ml->funcs->get_model_info (ml->backend_private, ops, in_info, out_info);
+}
+
+int
+hal_ml_request_event_handler (hal_ml_h handle, int ops, void *data)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  if (G_UNLIKELY (!handle)) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (ml->client)
+    return hal_ml_remote_not_supported (ml, "eventHandler");
+
+  return ml->funcs->event_handler (ml->backend_private, ops, data);
+}
+
+int
+hal_ml_get_tensors_layout (hal_ml_h handle, hal_ml_tensors_layout_s *in_layout,
+    hal_ml_tensors_layout_s *out_layout)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  int ret = HAL_ML_ERROR_NONE;
+
+  if (G_UNLIKELY (!handle || (!in_layout && !out_layout))) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (ml->client) {
+    hal_ml_client_get_tensors_layout (ml->client, in_layout, out_layout);
+    return HAL_ML_ERROR_NONE;
+  }
+
+  g_mutex_lock (&ml->lock);
+  if (!ml->layout_cached) {
+    if (!ml->funcs->get_tensors_layout) {
+      _E ("Backend %s does not provide the tensor layout.", ml->backend_library_name);
+      ret = HAL_ML_ERROR_NOT_SUPPORTED;
+    } else {
+      ret = ml->funcs->get_tensors_layout (ml->backend_private, &ml->in_layout, &ml->out_layout);
+      if (ret == HAL_ML_ERROR_NONE && (!hal_ml_layout_is_valid (&ml->in_layout)
+              || !hal_ml_layout_is_valid (&ml->out_layout))) {
+        _E ("Backend %s returned an invalid tensor layout.", ml->backend_library_name);
+        ret = HAL_ML_ERROR_RUNTIME_ERROR;
+      }
+      ml->layout_cached = (ret == HAL_ML_ERROR_NONE);
+    }
+  }
+
+  if (ret == HAL_ML_ERROR_NONE) {
+    if (in_layout)
+      *in_layout = ml->in_layout;
+    if (out_layout)
+      *out_layout = ml->out_layout;
+  }
+  g_mutex_unlock (&ml->lock);
+
+  return ret;
+}
+
+/**
+ * @brief The start of a block of tensors, before the array of hal_ml_tensor_memory_s.
+ */
+typedef struct _hal_ml_tensors_block_s {
+  gsize mapped_size; /* the size of the mapping bound to a NUMA node, 0 if from posix_memalign () */
+} hal_ml_tensors_block_s;
+
+#define HAL_ML_TENSORS_BLOCK_HEADER HAL_ML_TENSOR_ALIGN_UP (sizeof (hal_ml_tensors_block_s))
+
+int
+hal_ml_tensors_alloc_on_node (const hal_ml_tensors_layout_s *layout, int numa_node, void **tensors)
+{
+  hal_ml_tensors_block_s *block;
+  hal_ml_tensor_memory_s *mem;
+  gsize header, total;
+  guint8 *data;
+
+  if (!hal_ml_layout_is_valid (layout) || !tensors
+      || (numa_node != -1 && !hal_ml_placement_node_is_valid (numa_node))) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  /* One block: the array terminated by an empty entry, then each tensor at an aligned offset. */
+  header = HAL_ML_TENSOR_ALIGN_UP ((layout->num_tensors + 1) * sizeof (hal_ml_tensor_memory_s));
+  total = HAL_ML_TENSORS_BLOCK_HEADER + header;
+  for (guint i = 0; i < layout->num_tensors; i++)
+    total += HAL_ML_TENSOR_ALIGN_UP (layout->size[i]);
+
+  if (numa_node < 0) {
+    if (posix_memalign ((void **) &block, HAL_ML_TENSOR_ALIGN, total) != 0)
+      return HAL_ML_ERROR_OUT_OF_MEMORY;
+    block->mapped_size = 0;
+  } else {
+    gsize page = (gsize) sysconf (_SC_PAGESIZE);
+
+    /* Pages of its own, so the binding does not affect other allocations. */
+    total = (total + page - 1) / page * page;
+    block = (hal_ml_tensors_block_s *) mmap (NULL, total, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED)
+      return HAL_ML_ERROR_OUT_OF_MEMORY;
+
+    hal_ml_placement_bind_memory (block, total, numa_node);
+    memset (block, 0, total);
+    block->mapped_size = total;
+  }
+
+  mem = (hal_ml_tensor_memory_s *) ((guint8 *) block + HAL_ML_TENSORS_BLOCK_HEADER);
+  data = (guint8 *) mem + header;
+  for (guint i = 0; i < layout->num_tensors; i++) {
+    mem[i].data = data;
+    mem[i].size = layout->size[i];
+    data += HAL_ML_TENSOR_ALIGN_UP (layout->size[i]);
+  }
+  mem[layout->num_tensors].data = NULL;
+  mem[layout->num_tensors].size = 0;
+
+  *tensors = mem;
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_tensors_alloc (const hal_ml_tensors_layout_s *layout, void **tensors)
+{
+  return hal_ml_tensors_alloc_on_node (layout, -1, tensors);
+}
+
+void
+hal_ml_tensors_free (void *tensors)
+{
+  hal_ml_tensors_block_s *block;
+
+  if (!tensors)
+    return;
+
+  block = (hal_ml_tensors_block_s *) ((guint8 *) tensors - HAL_ML_TENSORS_BLOCK_HEADER);
+  if (block->mapped_size)
+    munmap (block, block->mapped_size);
+  else
+    free (block);
+}
+
+int
+hal_ml_request_invoke_alloc (hal_ml_h handle, const void *input, void **output)
+{
+  hal_ml_tensors_layout_s out_layout;
+  void *tensors = NULL;
+  int ret;
+
+  if (G_UNLIKELY (!handle || !output)) {
+    _E ("Got invalid parameter");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  ret = hal_ml_get_tensors_layout (handle, NULL, &out_layout);
+  if (ret == HAL_ML_ERROR_NONE)
+    ret = hal_ml_tensors_alloc_on_node (&out_layout,
+        hal_ml_placement_get_node ((hal_ml_s *) handle), &tensors);
+  if (ret == HAL_ML_ERROR_NONE)
+    ret = hal_ml_request_invoke (handle, input, tensors);
+
+  if (ret != HAL_ML_ERROR_NONE) {
+    hal_ml_tensors_free (tensors);
+    return ret;
+  }
+
+  *output = tensors;
+  return HAL_ML_ERROR_NONE;
+}
+
+int
+hal_ml_request_invoke_timeout (hal_ml_h handle, const void *input, void *output, int timeout_ms)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+  hal_ml_invoke_job_s job = { 0 };
+  gboolean canceling = FALSE;
+  int ret;
+
+  if (G_UNLIKELY (!handle)) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  if (G_UNLIKELY (timeout_ms <= 0)) {
+    _E ("Got invalid timeout %d", timeout_ms);
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  job.input = input;
+  job.output = output;
+  job.deadline = g_get_monotonic_time () + (gint64) timeout_ms * G_TIME_SPAN_MILLISECOND;
+
+  g_mutex_lock (&ml->lock);
+  ret = hal_ml_queue_job (ml, &job);
+  if (ret != HAL_ML_ERROR_NONE) {
+    g_mutex_unlock (&ml->lock);
+    return ret;
+  }
+
+  while (job.state != HAL_ML_INVOKE_JOB_DONE) {
+    if (canceling) {
+      g_cond_wait (&ml->cond, &ml->lock);
+      continue;
+    }
+
+    if (g_cond_wait_until (&ml->cond, &ml->lock, job.deadline))
+      continue;
+
+    if (job.state == HAL_ML_INVOKE_JOB_QUEUED) {
+      g_queue_remove (&ml->pending, &job);
+      job.result = HAL_ML_ERROR_TIMED_OUT;
+      job.state = HAL_ML_INVOKE_JOB_DONE;
+    } else if (job.state == HAL_ML_INVOKE_JOB_RUNNING) {
+      /* The backend owns the buffers until invoke returns, so wait for it after canceling.
+       * The lock keeps the worker on this job, so the cancel cannot hit the next one. */
+      job.cancel_requested = TRUE;
+      canceling = TRUE;
+      if (ml->funcs && ml->funcs->cancel) {
+        ml->funcs->cancel (ml->backend_private);
+      } else {
+        _W ("Backend %s does not support cancel, waiting for the invoke to finish.",
+            ml->backend_library_name);
+      }
+    }
+  }
+  g_mutex_unlock (&ml->lock);
+
+  /* A backend which could not stop the invoke in time may still have finished it. */
+  if (canceling && job.result == HAL_ML_ERROR_CANCELED)
+    return HAL_ML_ERROR_TIMED_OUT;
+
+  return job.result;
+}
+
+int
+hal_ml_request_cancel (hal_ml_h handle)
+{
+  hal_ml_s *ml = (hal_ml_s *) handle;
+
+  if (!handle) {
+    _E ("Got invalid handle");
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+  }
+
+  g_mutex_lock (&ml->lock);
+  ml->cancel_gen++;
+  hal_ml_flush_pending (ml, HAL_ML_ERROR_CANCELED);
+  if (ml->running) {
+    ml->running->cancel_requested = TRUE;
+    /* Cancel with the lock held, while the running job cannot complete and be replaced. */
+    if (ml->funcs && ml->funcs->cancel)
+      ml->funcs->cancel (ml->backend_private);
+  }
+  g_mutex_unlock (&ml->lock);
+
+  return HAL_ML_ERROR_NONE;
 }
@@ -0,0 +1,227 @@
+/**
+ * Tests for automatic backend selection of hal-ml
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-auto.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for automatic backend selection of hal-ml
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ *    The candidates are the loopback backend and the faster "turbo" one.
+ *    The profile cache is a file in the temporary directory.
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+#include "ml-haltests-loopback.h"
+
+#define AUTO_TENSOR_SIZE (64)
+#define AUTO_DELAY_US (2000)
+
+/**
+ * @brief Fixture with a profile cache of its own.
+ */
+class HAL_ML_AUTO : public ::testing::Test
+{
+  protected:
+  void SetUp () override
+  {
+    path = std::string ("/tmp/hal-ml-haltests-") + std::to_string (getpid ()) + "-profile.ini";
+    setenv (HAL_ML_PROFILE_CACHE_ENV, path.c_str (), 1);
+    remove (path.c_str ());
+  }
+
+  void TearDown () override
+  {
+    remove (path.c_str ());
+    unsetenv (HAL_ML_PROFILE_CACHE_ENV);
+    EXPECT_EQ (loopback_get_live_instances (), 0);
+  }
+
+  /**
+   * @brief Creates a handle with hal_ml_create_auto () and returns its backend name, or "" on failure.
+   */
+  std::string create_auto (const char *model_key, hal_ml_auto_objective_e objective)
+  {
+    hal_ml_h ml;
+    const char *name;
+    std::string backend;
+
+    if (hal_ml_create_auto (model_key, &prop, nullptr, nullptr, objective, &ml) != HAL_ML_ERROR_NONE)
+      return backend;
+
+    if (hal_ml_get_backend_name (ml, &name) == HAL_ML_ERROR_NONE)
+      backend = name;
+    hal_ml_destroy (ml);
+    return backend;
+  }
+
+  void write_cache (const char *content)
+  {
+    FILE *fp = fopen (path.c_str (), "w");
+
+    ASSERT_NE (fp, nullptr);
+    fputs (content, fp);
+    fclose (fp);
+  }
+
+  std::string path;
+  loopback_prop_s prop = { AUTO_DELAY_US, AUTO_TENSOR_SIZE };
+};
+
+TEST_F (HAL_ML_AUTO, fastest_backend)
+{
+  hal_ml_h ml;
+  const char *name;
+  unsigned char in_data[AUTO_TENSOR_SIZE], out_data[AUTO_TENSOR_SIZE] = { 0 };
+  loopback_tensor_s in[2] = { { in_data, sizeof (in_data) }, { nullptr, 0 } };
+  loopback_tensor_s out[2] = { { out_data, sizeof (out_data) }, { nullptr, 0 } };
+
+  memset (in_data, 0x3c, sizeof (in_data));
+
+  /* Without a model key, the backends are measured with the given tensors. */
+  ASSERT_EQ (hal_ml_create_auto (nullptr, &prop, in, out, HAL_ML_AUTO_OBJECTIVE_LATENCY, &ml),
+      HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_get_backend_name (ml, &name), HAL_ML_ERROR_NONE);
+  EXPECT_NE (strstr (name, LOOPBACK_TURBO_BACKEND_NAME), nullptr);
+  EXPECT_EQ (memcmp (in_data, out_data, sizeof (in_data)), 0);
+
+  /* Only the chosen instance is left, configured. */
+  EXPECT_EQ (loopback_get_live_instances (), 1);
+  memset (out_data, 0, sizeof (out_data));
+  EXPECT_EQ (hal_ml_request_invoke (ml, in, out), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (memcmp (in_data, out_data, sizeof (in_data)), 0);
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+
+  EXPECT_NE (access (path.c_str (), F_OK), 0);
+}
+
+TEST_F (HAL_ML_AUTO, profile_cache)
+{
+  unsigned long invokes = loopback_get_invoke_count ();
+  std::string backend;
+
+  backend = create_auto ("model-a", HAL_ML_AUTO_OBJECTIVE_LATENCY);
+  EXPECT_NE (backend.find (LOOPBACK_TURBO_BACKEND_NAME), std::string::npos);
+  EXPECT_GT (loopback_get_invoke_count (), invokes);
+  EXPECT_EQ (access (path.c_str (), F_OK), 0);
+
+  /* Both objectives are answered from the cache without invoking. */
+  invokes = loopback_get_invoke_count ();
+  EXPECT_EQ (create_auto ("model-a", HAL_ML_AUTO_OBJECTIVE_LATENCY), backend);
+  EXPECT_EQ (create_auto ("model-a", HAL_ML_AUTO_OBJECTIVE_THROUGHPUT), backend);
+  EXPECT_EQ (loopback_get_invoke_count (), invokes);
+
+  /* Another model is measured on its own. */
+  EXPECT_EQ (create_auto ("model-b", HAL_ML_AUTO_OBJECTIVE_THROUGHPUT), backend);
+  EXPECT_GT (loopback_get_invoke_count (), invokes);
+}
+
+TEST_F (HAL_ML_AUTO, cached_decision)
+{
+  unsigned long invokes;
+
+  /* The cache decides, even against the real speed. */
+  write_cache ("[model]\n"
+               "backends=libhal-backend-ml-loopback.so;libhal-backend-ml-turbo.so;\n"
+               "libhal-backend-ml-loopback.so=10;50;\n"
+               "libhal-backend-ml-turbo.so=20;30;\n");
+
+  invokes = loopback_get_invoke_count ();
+  EXPECT_NE (create_auto ("model", HAL_ML_AUTO_OBJECTIVE_LATENCY).find (LOOPBACK_BACKEND_NAME), std::string::npos);
+  EXPECT_NE (create_auto ("model", HAL_ML_AUTO_OBJECTIVE_THROUGHPUT).find (LOOPBACK_TURBO_BACKEND_NAME), std::string::npos);
+  EXPECT_EQ (loopback_get_invoke_count (), invokes);
+
+  /* A failed backend is skipped. */
+  write_cache ("[model]\n"
+               "backends=libhal-backend-ml-loopback.so;libhal-backend-ml-turbo.so;\n"
+               "libhal-backend-ml-loopback.so=10;10;\n"
+               "libhal-backend-ml-turbo.so=-1;-1;\n");
+  EXPECT_NE (create_auto ("model", HAL_ML_AUTO_OBJECTIVE_THROUGHPUT).find (LOOPBACK_BACKEND_NAME), std::string::npos);
+  EXPECT_EQ (loopback_get_invoke_count (), invokes);
+
+  /* A backend which rejected the model is not stored, and is not chosen. */
+  write_cache ("[model]\n"
+               "backends=libhal-backend-ml-loopback.so;libhal-backend-ml-turbo.so;\n"
+               "libhal-backend-ml-loopback.so=10;10;\n");
+  EXPECT_NE (create_auto ("model", HAL_ML_AUTO_OBJECTIVE_LATENCY).find (LOOPBACK_BACKEND_NAME), std::string::npos);
+  EXPECT_EQ (loopback_get_invoke_count (), invokes);
+
+  /* A backend missing in the profile, e.g. newly installed, makes the model measured again. */
+  write_cache ("[model]\n"
+               "backends=libhal-backend-ml-loopback.so;\n"
+               "libhal-backend-ml-loopback.so=10;10;\n");
+  EXPECT_NE (create_auto ("model", HAL_ML_AUTO_OBJECTIVE_LATENCY).find (LOOPBACK_TURBO_BACKEND_NAME), std::string::npos);
+  EXPECT_GT (loopback_get_invoke_count (), invokes);
+}
+
+TEST_F (HAL_ML_AUTO, failed_profile)
+{
+  unsigned long invokes = loopback_get_invoke_count ();
+
+  /* A profile where every backend failed, e.g. written by an older version, is measured again. */
+  write_cache ("[model]\n"
+               "backends=libhal-backend-ml-loopback.so;libhal-backend-ml-turbo.so;\n"
+               "libhal-backend-ml-loopback.so=-1;-1;\n"
+               "libhal-backend-ml-turbo.so=-1;-1;\n");
+  EXPECT_NE (create_auto ("model", HAL_ML_AUTO_OBJECTIVE_LATENCY).find (LOOPBACK_TURBO_BACKEND_NAME), std::string::npos);
+  EXPECT_GT (loopback_get_invoke_count (), invokes);
+
+  /* The new profile is used. */
+  invokes = loopback_get_invoke_count ();
+  EXPECT_NE (create_auto ("model", HAL_ML_AUTO_OBJECTIVE_THROUGHPUT).find (LOOPBACK_TURBO_BACKEND_NAME), std::string::npos);
+  EXPECT_EQ (loopback_get_invoke_count (), invokes);
+
+  /* A profile without the list of backends is measured again. */
+  write_cache ("[model]\n"
+               "libhal-backend-ml-loopback.so=10;10;\n"
+               "libhal-backend-ml-turbo.so=20;20;\n");
+  EXPECT_NE (create_auto ("model", HAL_ML_AUTO_OBJECTIVE_LATENCY).find (LOOPBACK_TURBO_BACKEND_NAME), std::string::npos);
+  EXPECT_GT (loopback_get_invoke_count (), invokes);
+}
+
+TEST_F (HAL_ML_AUTO, no_layout_n)
+{
+  hal_ml_h ml;
+  loopback_prop_s no_layout = { 0, 0 };
+
+  /* Without sample tensors, the backends have to provide the layout; this is not cached as unsupported. */
+  EXPECT_EQ (hal_ml_create_auto ("model", &no_layout, nullptr, nullptr, HAL_ML_AUTO_OBJECTIVE_LATENCY, &ml),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_create_auto ("model", &no_layout, nullptr, nullptr, HAL_ML_AUTO_OBJECTIVE_LATENCY, &ml),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_NE (access (path.c_str (), F_OK), 0);
+
+  /* The model is measured once the backends can run it. */
+  EXPECT_NE (create_auto ("model", HAL_ML_AUTO_OBJECTIVE_LATENCY).find (LOOPBACK_TURBO_BACKEND_NAME), std::string::npos);
+  EXPECT_EQ (access (path.c_str (), F_OK), 0);
+
+  /* A bad property keeps the profile. */
+  EXPECT_EQ (hal_ml_create_auto ("model-b", &no_layout, nullptr, nullptr, HAL_ML_AUTO_OBJECTIVE_LATENCY, &ml),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (access (path.c_str (), F_OK), 0);
+}
+
+TEST_F (HAL_ML_AUTO, no_backend_n)
+{
+  hal_ml_h ml;
+
+  EXPECT_EQ (hal_ml_create_auto ("model[0]", &prop, nullptr, nullptr, HAL_ML_AUTO_OBJECTIVE_LATENCY, &ml),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_create_auto ("", &prop, nullptr, nullptr, HAL_ML_AUTO_OBJECTIVE_LATENCY, &ml),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_create_auto ("model", nullptr, nullptr, nullptr, HAL_ML_AUTO_OBJECTIVE_LATENCY, &ml),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+}
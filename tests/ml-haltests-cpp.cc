@@ -0,0 +1,124 @@
+/**
+ * Tests for the C++ wrapper of HAL ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-cpp.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for the C++ wrapper of HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.hpp>
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "ml-haltests-loopback.h"
+
+using hal::ml::Handle;
+using hal::ml::Op;
+using hal::ml::Param;
+using hal::ml::Tensors;
+
+static_assert (!std::is_copy_constructible<Handle>::value, "Handle should be move-only");
+static_assert (!std::is_copy_assignable<Handle>::value, "Handle should be move-only");
+static_assert (std::is_nothrow_move_constructible<Handle>::value, "Handle should move without throwing");
+static_assert (std::is_nothrow_move_assignable<Handle>::value, "Handle should move without throwing");
+static_assert (!std::is_copy_constructible<Param>::value, "Param should be move-only");
+static_assert (std::is_nothrow_move_constructible<Param>::value, "Param should move without throwing");
+static_assert (sizeof (Tensors<2>) == 3 * sizeof (hal_ml_tensor_memory_s), "Tensors should hold no more than the array");
+
+static Handle
+create_loopback (void)
+{
+  Handle handle;
+  loopback_prop_s prop = { 0 };
+
+  if (Handle::create (LOOPBACK_BACKEND_NAME, handle) == HAL_ML_ERROR_NONE)
+    handle.configure (&prop);
+
+  return handle;
+}
+
+TEST (HAL_ML_CPP, handle_move)
+{
+  Handle a = create_loopback ();
+  ASSERT_TRUE (a);
+  EXPECT_EQ (loopback_get_live_instances (), 1);
+
+  Handle b (std::move (a));
+  EXPECT_FALSE (a);
+  EXPECT_TRUE (b);
+
+  a = std::move (b);
+  EXPECT_TRUE (a);
+  EXPECT_FALSE (b);
+  EXPECT_EQ (loopback_get_live_instances (), 1);
+
+  /* Assigning over a live handle destroys it. */
+  a = create_loopback ();
+  EXPECT_EQ (loopback_get_live_instances (), 1);
+
+  a.reset ();
+  EXPECT_EQ (loopback_get_live_instances (), 0);
+}
+
+TEST (HAL_ML_CPP, typed_requests)
+{
+  Handle handle = create_loopback ();
+  unsigned char in_data[16], out_data[16] = { 0 };
+  Tensors<1> input, output;
+
+  ASSERT_TRUE (handle);
+  memset (in_data, 0x42, sizeof (in_data));
+  input.set (0, in_data, sizeof (in_data));
+  output.set (0, out_data, sizeof (out_data));
+
+  EXPECT_EQ (handle.invoke (input, output), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (memcmp (in_data, out_data, sizeof (in_data)), 0);
+
+  memset (out_data, 0, sizeof (out_data));
+  EXPECT_EQ (handle.request<Op::Invoke> (input.data (), output.data ()), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (memcmp (in_data, out_data, sizeof (in_data)), 0);
+  EXPECT_EQ (handle.invoke_timeout (input, output, 1000), HAL_ML_ERROR_NONE);
+
+  /* The loopback backend has no model information. */
+  EXPECT_EQ (handle.request<Op::GetModelInfo> (0, nullptr, nullptr), HAL_ML_ERROR_NOT_SUPPORTED);
+  EXPECT_EQ (handle.request<Op::GetFrameworkInfo> (nullptr), HAL_ML_ERROR_NOT_SUPPORTED);
+  EXPECT_EQ (handle.request<Op::EventHandler> (0, nullptr), HAL_ML_ERROR_NOT_SUPPORTED);
+}
+
+TEST (HAL_ML_CPP, request_by_name)
+{
+  Handle handle = create_loopback ();
+  Param param;
+  unsigned char in_data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 }, out_data[8] = { 0 };
+  loopback_tensor_s in = { in_data, sizeof (in_data) };
+  loopback_tensor_s out = { out_data, sizeof (out_data) };
+
+  ASSERT_EQ (Param::create (param), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (param.set ("input", &in), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (param.set ("output", &out), HAL_ML_ERROR_NONE);
+
+  Param moved (std::move (param));
+  EXPECT_FALSE (param);
+  EXPECT_EQ (handle.request ("invoke", moved), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (memcmp (in_data, out_data, sizeof (in_data)), 0);
+}
+
+TEST (HAL_ML_CPP, invalid_n)
+{
+  Handle handle;
+  Tensors<1> input, output;
+
+  EXPECT_NE (Handle::create ("no_such_backend", handle), HAL_ML_ERROR_NONE);
+  EXPECT_FALSE (handle);
+  EXPECT_EQ (handle.invoke (input, output), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (handle.request<Op::ConfigureInstance> (nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+}
@@ -0,0 +1,236 @@
+/**
+ * Tests for hal-ml daemon and its clients
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-daemon.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for hal-ml daemon and its clients
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ *    The daemon runs in the test process with the loopback backend, and the
+ *    clients connect to it over a socket in the temporary directory, from
+ *    threads of this process and from a forked process.
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ml-haltests-loopback.h"
+
+#define DAEMON_TENSOR_SIZE (64)
+
+/**
+ * @brief Fixture running hal-ml daemon with a shared loopback instance named "echo".
+ */
+class HAL_ML_DAEMON : public ::testing::Test
+{
+  protected:
+  void SetUp () override
+  {
+    hal_ml_tensors_layout_s layout = { 0 };
+
+    path = std::string ("/tmp/hal-ml-haltests-") + std::to_string (getpid ()) + ".sock";
+    setenv (HAL_ML_DAEMON_SOCKET_ENV, path.c_str (), 1);
+
+    layout.num_tensors = 1;
+    layout.size[0] = DAEMON_TENSOR_SIZE;
+
+    ASSERT_EQ (hal_ml_server_create (path.c_str (), &server), HAL_ML_ERROR_NONE);
+    ASSERT_EQ (hal_ml_server_add_instance (server, "echo", LOOPBACK_BACKEND_NAME,
+                   &prop, &layout, &layout),
+        HAL_ML_ERROR_NONE);
+  }
+
+  void TearDown () override
+  {
+    EXPECT_EQ (hal_ml_server_destroy (server), HAL_ML_ERROR_NONE);
+    EXPECT_EQ (loopback_get_live_instances (), 0);
+    unsetenv (HAL_ML_DAEMON_SOCKET_ENV);
+  }
+
+  std::string path;
+  hal_ml_server_h server = nullptr;
+  loopback_prop_s prop = { 0 };
+};
+
+/**
+ * @brief Invokes with the shared tensors and checks the loopback output. Returns the number of mismatches.
+ */
+static int
+invoke_shared (hal_ml_h ml, int rounds, unsigned char seed)
+{
+  loopback_tensor_s *in, *out;
+  int mismatches = 0;
+
+  if (hal_ml_get_shared_tensors (ml, (void **) &in, (void **) &out) != HAL_ML_ERROR_NONE)
+    return rounds;
+
+  for (int r = 0; r < rounds; r++) {
+    memset (in[0].data, seed + r, in[0].size);
+
+    if (hal_ml_request_invoke (ml, in, out) != HAL_ML_ERROR_NONE
+        || memcmp (in[0].data, out[0].data, out[0].size) != 0)
+      mismatches++;
+  }
+
+  return mismatches;
+}
+
+TEST_F (HAL_ML_DAEMON, shared_instance)
+{
+  const int num_clients = 4;
+  std::vector<hal_ml_h> clients (num_clients);
+  std::vector<std::thread> threads;
+  std::vector<int> mismatches (num_clients, 0);
+  unsigned long invokes = loopback_get_invoke_count ();
+
+  for (auto &ml : clients)
+    ASSERT_EQ (hal_ml_create (HAL_ML_DAEMON_PREFIX "echo", &ml), HAL_ML_ERROR_NONE);
+
+  /* All clients share the one instance of the daemon. */
+  EXPECT_EQ (loopback_get_live_instances (), 1);
+
+  for (int c = 0; c < num_clients; c++)
+    threads.emplace_back ([&, c] { mismatches[c] = invoke_shared (clients[c], 200, c * 16); });
+  for (auto &t : threads)
+    t.join ();
+
+  for (int c = 0; c < num_clients; c++)
+    EXPECT_EQ (mismatches[c], 0);
+  EXPECT_EQ (loopback_get_invoke_count () - invokes, (unsigned long) num_clients * 200);
+
+  for (auto ml : clients)
+    EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (loopback_get_live_instances (), 1);
+}
+
+TEST_F (HAL_ML_DAEMON, private_buffers)
+{
+  hal_ml_h ml;
+  hal_ml_param_h param;
+  unsigned char in_data[DAEMON_TENSOR_SIZE], out_data[DAEMON_TENSOR_SIZE] = { 0 };
+  loopback_tensor_s in[2] = { { in_data, sizeof (in_data) }, { nullptr, 0 } };
+  loopback_tensor_s out[2] = { { out_data, sizeof (out_data) }, { nullptr, 0 } };
+  loopback_tensor_s bad[2] = { { out_data, 1 }, { nullptr, 0 } };
+
+  memset (in_data, 0x5a, sizeof (in_data));
+
+  ASSERT_EQ (hal_ml_create (HAL_ML_DAEMON_PREFIX "echo", &ml), HAL_ML_ERROR_NONE);
+
+  /* Buffers of the caller are copied through the shared memory. */
+  ASSERT_EQ (hal_ml_param_create (&param), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_param_set (param, "properties", &prop), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_request (ml, "configure_instance", param), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_param_set (param, "input", in), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_param_set (param, "output", out), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_request (ml, "invoke", param), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_param_destroy (param), HAL_ML_ERROR_NONE);
+
+  EXPECT_EQ (memcmp (in_data, out_data, sizeof (in_data)), 0);
+
+  /* Backend structures cannot cross the process boundary. */
+  EXPECT_EQ (hal_ml_request_get_model_info (ml, 0, nullptr, nullptr), HAL_ML_ERROR_NOT_SUPPORTED);
+  EXPECT_EQ (hal_ml_request_invoke (ml, in, bad), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_request_invoke_timeout (ml, in, out, 1000), HAL_ML_ERROR_NONE);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST_F (HAL_ML_DAEMON, other_process)
+{
+  int status = -1;
+  pid_t pid = fork ();
+
+  ASSERT_GE (pid, 0);
+  if (pid == 0) {
+    hal_ml_h ml;
+    int failures = 0;
+
+    if (hal_ml_create (HAL_ML_DAEMON_PREFIX "echo", &ml) != HAL_ML_ERROR_NONE)
+      _exit (2);
+    failures = invoke_shared (ml, 100, 7);
+    hal_ml_destroy (ml);
+    _exit (failures == 0 ? 0 : 1);
+  }
+
+  ASSERT_EQ (waitpid (pid, &status, 0), pid);
+  EXPECT_TRUE (WIFEXITED (status));
+  EXPECT_EQ (WEXITSTATUS (status), 0);
+}
+
+TEST_F (HAL_ML_DAEMON, socket_file)
+{
+  std::string file = path + ".file";
+  hal_ml_server_h other;
+  struct stat st;
+  FILE *fp;
+
+  /* Only the user of the daemon can connect. */
+  ASSERT_EQ (lstat (path.c_str (), &st), 0);
+  EXPECT_TRUE (S_ISSOCK (st.st_mode));
+  EXPECT_EQ (st.st_mode & 0777, 0600U);
+
+  /* A file which is not a socket is kept. */
+  fp = fopen (file.c_str (), "w");
+  ASSERT_NE (fp, nullptr);
+  fclose (fp);
+  EXPECT_EQ (hal_ml_server_create (file.c_str (), &other), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (access (file.c_str (), F_OK), 0);
+  remove (file.c_str ());
+}
+
+TEST_F (HAL_ML_DAEMON, other_user_n)
+{
+  int status = -1;
+  pid_t pid;
+
+  if (geteuid () != 0)
+    GTEST_SKIP () << "Needs root to run a client as another user";
+
+  /* Even if the socket file is opened up, the daemon rejects a client of another user. */
+  ASSERT_EQ (chmod (path.c_str (), 0666), 0);
+  pid = fork ();
+  ASSERT_GE (pid, 0);
+  if (pid == 0) {
+    hal_ml_h ml;
+
+    if (setuid (65534) != 0)
+      _exit (2);
+    _exit (hal_ml_create (HAL_ML_DAEMON_PREFIX "echo", &ml) == HAL_ML_ERROR_NONE ? 1 : 0);
+  }
+
+  ASSERT_EQ (waitpid (pid, &status, 0), pid);
+  EXPECT_TRUE (WIFEXITED (status));
+  EXPECT_EQ (WEXITSTATUS (status), 0);
+}
+
+TEST_F (HAL_ML_DAEMON, unknown_instance_n)
+{
+  hal_ml_h ml;
+  hal_ml_tensors_layout_s layout = { 0 };
+
+  EXPECT_EQ (hal_ml_create (HAL_ML_DAEMON_PREFIX "unknown", &ml), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_server_add_instance (server, "echo", LOOPBACK_BACKEND_NAME, &prop, &layout, &layout),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+
+  layout.num_tensors = 1;
+  layout.size[0] = 4;
+  EXPECT_EQ (hal_ml_server_add_instance (server, "echo", LOOPBACK_BACKEND_NAME, &prop, &layout, &layout),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (loopback_get_live_instances (), 1);
+}
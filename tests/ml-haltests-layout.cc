@@ -0,0 +1,175 @@
+/**
+ * Tests for the cached tensor layout of HAL ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-layout.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for the cached tensor layout of HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+#include "ml-haltests-loopback.h"
+
+static hal_ml_h
+create_with_size (size_t tensor_size)
+{
+  hal_ml_h ml = nullptr;
+  loopback_prop_s prop = { 0, tensor_size };
+
+  if (hal_ml_create (LOOPBACK_BACKEND_NAME, &ml) != HAL_ML_ERROR_NONE)
+    return nullptr;
+  if (hal_ml_request_configure_instance (ml, &prop) != HAL_ML_ERROR_NONE) {
+    hal_ml_destroy (ml);
+    return nullptr;
+  }
+
+  return ml;
+}
+
+TEST (HAL_ML_LAYOUT, cached)
+{
+  hal_ml_h ml = create_with_size (32);
+  hal_ml_tensors_layout_s in_layout, out_layout;
+  unsigned long queries = loopback_get_layout_queries ();
+  loopback_prop_s prop = { 0, 16 };
+
+  ASSERT_NE (ml, nullptr);
+  EXPECT_EQ (hal_ml_get_tensors_layout (ml, &in_layout, &out_layout), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (in_layout.num_tensors, 1U);
+  EXPECT_EQ (out_layout.size[0], 32U);
+  EXPECT_EQ (hal_ml_get_tensors_layout (ml, nullptr, &out_layout), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (loopback_get_layout_queries () - queries, 1U);
+
+  /* Configuring again refreshes the layout. */
+  EXPECT_EQ (hal_ml_request_configure_instance (ml, &prop), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_get_tensors_layout (ml, &in_layout, nullptr), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (in_layout.size[0], 16U);
+  EXPECT_EQ (loopback_get_layout_queries () - queries, 2U);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_LAYOUT, invoke_alloc)
+{
+  hal_ml_h ml = create_with_size (100);
+  unsigned char in_data[100];
+  loopback_tensor_s in[2] = { { in_data, sizeof (in_data) }, { nullptr, 0 } };
+  loopback_tensor_s *out = nullptr;
+  unsigned long queries;
+
+  ASSERT_NE (ml, nullptr);
+  memset (in_data, 0x3c, sizeof (in_data));
+
+  EXPECT_EQ (hal_ml_request_invoke_alloc (ml, in, (void **) &out), HAL_ML_ERROR_NONE);
+  ASSERT_NE (out, nullptr);
+  EXPECT_EQ (out[0].size, sizeof (in_data));
+  EXPECT_EQ ((uintptr_t) out[0].data % 64, 0U);
+  EXPECT_EQ (out[1].data, nullptr);
+  EXPECT_EQ (memcmp (out[0].data, in_data, sizeof (in_data)), 0);
+  hal_ml_tensors_free (out);
+
+  /* The hot path does not ask the backend again. */
+  queries = loopback_get_layout_queries ();
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ (hal_ml_request_invoke_alloc (ml, in, (void **) &out), HAL_ML_ERROR_NONE);
+    hal_ml_tensors_free (out);
+  }
+  EXPECT_EQ (loopback_get_layout_queries (), queries);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_LAYOUT, invoke_dynamic)
+{
+  hal_ml_h ml = create_with_size (8);
+  hal_ml_tensors_layout_s out_layout;
+  unsigned char in_data[8] = { 0 }, out_data[8];
+  loopback_tensor_s in = { in_data, sizeof (in_data) };
+  loopback_tensor_s out = { out_data, sizeof (out_data) };
+  loopback_prop_s prop = { 0, 4 }, same = { 0, 8 };
+  unsigned long queries;
+
+  ASSERT_NE (ml, nullptr);
+  EXPECT_EQ (hal_ml_get_tensors_layout (ml, nullptr, &out_layout), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (out_layout.size[0], 8U);
+
+  /* The layout stays cached if a dynamic invoke keeps the shape. */
+  EXPECT_EQ (hal_ml_request_invoke_dynamic (ml, &same, &in, &out), HAL_ML_ERROR_NONE);
+  queries = loopback_get_layout_queries ();
+  EXPECT_EQ (hal_ml_get_tensors_layout (ml, nullptr, &out_layout), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (out_layout.size[0], 8U);
+  EXPECT_EQ (loopback_get_layout_queries (), queries);
+
+  /* A dynamic invoke may change the output shape. */
+  EXPECT_EQ (hal_ml_request_invoke_dynamic (ml, &prop, &in, &out), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_get_tensors_layout (ml, nullptr, &out_layout), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (out_layout.size[0], 4U);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_LAYOUT, users_of_layout)
+{
+  hal_ml_h ml = create_with_size (24);
+  hal_ml_h remote;
+  hal_ml_pipeline_h pipe;
+  hal_ml_server_h server;
+  hal_ml_tensors_layout_s out_layout;
+  loopback_prop_s prop = { 0, 48 };
+  std::string path = "/tmp/hal-ml-haltests-layout-" + std::to_string (getpid ()) + ".sock";
+
+  ASSERT_NE (ml, nullptr);
+
+  /* A pipeline stage without layouts takes the ones of the handle. */
+  ASSERT_EQ (hal_ml_pipeline_create (2, &pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml, nullptr, nullptr, nullptr, nullptr), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_destroy (pipe), HAL_ML_ERROR_NONE);
+
+  /* So does an instance of the daemon, and its clients see the layout too. */
+  setenv (HAL_ML_DAEMON_SOCKET_ENV, path.c_str (), 1);
+  ASSERT_EQ (hal_ml_server_create (path.c_str (), &server), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_server_add_instance (server, "sized", LOOPBACK_BACKEND_NAME, &prop, nullptr, nullptr),
+      HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_create (HAL_ML_DAEMON_PREFIX "sized", &remote), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_get_tensors_layout (remote, nullptr, &out_layout), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (out_layout.size[0], 48U);
+  EXPECT_EQ (hal_ml_destroy (remote), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_server_destroy (server), HAL_ML_ERROR_NONE);
+  unsetenv (HAL_ML_DAEMON_SOCKET_ENV);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_LAYOUT, not_provided_n)
+{
+  hal_ml_h ml = create_with_size (0);
+  hal_ml_tensors_layout_s layout;
+  hal_ml_pipeline_h pipe;
+  unsigned char data[4] = { 0 };
+  loopback_tensor_s in = { data, sizeof (data) };
+  void *out = nullptr;
+
+  ASSERT_NE (ml, nullptr);
+  EXPECT_EQ (hal_ml_get_tensors_layout (ml, &layout, &layout), HAL_ML_ERROR_NOT_SUPPORTED);
+  EXPECT_EQ (hal_ml_request_invoke_alloc (ml, &in, &out), HAL_ML_ERROR_NOT_SUPPORTED);
+  EXPECT_EQ (out, nullptr);
+
+  ASSERT_EQ (hal_ml_pipeline_create (2, &pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml, nullptr, nullptr, nullptr, nullptr),
+      HAL_ML_ERROR_NOT_SUPPORTED);
+  EXPECT_EQ (hal_ml_pipeline_destroy (pipe), HAL_ML_ERROR_NONE);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
@@ -0,0 +1,444 @@
+/**
+ * Loopback HAL ML backend for tests
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-loopback.cc
+ * @date    18 Oct 2026
+ * @brief   Loopback HAL ML backend for tests
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ *    hal-api-ml resolves backends through hal-api-common. The functions below
+ *    are defined in the test executable, so the dynamic linker binds
+ *    hal-api-ml to them instead of the ones in libhal-api-common.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <hal/hal-common.h>
+#include <hal-ml-interface.h>
+#include <hal-ml.h>
+
+#include "ml-haltests-loopback.h"
+
+#define LOOPBACK_LIBRARY_NAME "libhal-backend-ml-" LOOPBACK_BACKEND_NAME ".so"
+#define LOOPBACK_TURBO_LIBRARY_NAME "libhal-backend-ml-" LOOPBACK_TURBO_BACKEND_NAME ".so"
+#define LOOPBACK_TURBO_SPEEDUP (4)
+
+static std::mutex loopback_lock;
+static std::atomic<int> loopback_live_instances (0);
+static std::atomic<unsigned long> loopback_invoke_count (0);
+static std::atomic<unsigned long> loopback_layout_queries (0);
+static std::mutex loopback_affinity_lock;
+static cpu_set_t loopback_last_affinity;
+static std::mutex loopback_trace_lock;
+static bool loopback_tracing = false;
+static std::vector<loopback_trace_s> loopback_trace;
+static std::atomic<int> loopback_concurrency (0);
+static std::atomic<int> loopback_max_concurrency (0);
+static std::atomic<int> loopback_max_live_instances (0);
+
+/**
+ * @brief Raises @a peak to @a value if it is larger.
+ */
+static void
+loopback_update_peak (std::atomic<int> &peak, int value)
+{
+  int old = peak.load ();
+
+  while (value > old && !peak.compare_exchange_weak (old, value))
+    ;
+}
+
+typedef struct {
+  unsigned int delay_us;
+  unsigned int speedup; /* delay_us is divided by this */
+  size_t tensor_size;
+  unsigned int flags;
+  std::mutex cancel_lock;
+  bool invoking; /* A cancel is taken only while an invoke is running */
+  bool canceled;
+} loopback_private_s;
+
+static int
+loopback_init_with_speedup (void **backend_private, unsigned int speedup)
+{
+  loopback_private_s *priv = new loopback_private_s ();
+
+  priv->speedup = speedup;
+  *backend_private = priv;
+  loopback_update_peak (loopback_max_live_instances, ++loopback_live_instances);
+  return HAL_ML_ERROR_NONE;
+}
+
+static int
+loopback_init (void **backend_private)
+{
+  return loopback_init_with_speedup (backend_private, 1);
+}
+
+static int
+loopback_turbo_init (void **backend_private)
+{
+  return loopback_init_with_speedup (backend_private, LOOPBACK_TURBO_SPEEDUP);
+}
+
+static int
+loopback_deinit (void *backend_private)
+{
+  delete static_cast<loopback_private_s *> (backend_private);
+  loopback_live_instances--;
+  return HAL_ML_ERROR_NONE;
+}
+
+static int
+loopback_configure_instance (void *backend_private, const void *prop)
+{
+  loopback_private_s *priv = static_cast<loopback_private_s *> (backend_private);
+  const loopback_prop_s *lprop = static_cast<const loopback_prop_s *> (prop);
+
+  if (!priv || !lprop)
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+
+  priv->delay_us = lprop->delay_us / priv->speedup;
+  priv->tensor_size = lprop->tensor_size;
+  priv->flags = lprop->flags;
+  return HAL_ML_ERROR_NONE;
+}
+
+/**
+ * @brief Starts or ends the window in which a cancel applies, so a late cancel does not hit the next invoke.
+ */
+static void
+loopback_set_invoking (loopback_private_s *priv, bool invoking)
+{
+  std::lock_guard<std::mutex> lock (priv->cancel_lock);
+
+  priv->invoking = invoking;
+  priv->canceled = false;
+}
+
+static int
+loopback_invoke (void *backend_private, const void *input, void *output)
+{
+  loopback_private_s *priv = static_cast<loopback_private_s *> (backend_private);
+  const loopback_tensor_s *in = static_cast<const loopback_tensor_s *> (input);
+  loopback_tensor_s *out = static_cast<loopback_tensor_s *> (output);
+
+  if (!priv || !in || !out)
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+
+  loopback_update_peak (loopback_max_concurrency, ++loopback_concurrency);
+
+  if (priv->delay_us > 0) {
+    auto deadline = std::chrono::steady_clock::now () + std::chrono::microseconds (priv->delay_us);
+    bool canceled = false;
+
+    loopback_set_invoking (priv, (priv->flags & LOOPBACK_FLAG_NO_CANCEL) == 0);
+    while (!canceled && std::chrono::steady_clock::now () < deadline) {
+      std::this_thread::sleep_for (std::chrono::microseconds (std::min (priv->delay_us, 1000U)));
+      std::lock_guard<std::mutex> lock (priv->cancel_lock);
+      canceled = priv->canceled;
+    }
+    loopback_set_invoking (priv, false);
+
+    if (canceled) {
+      loopback_concurrency--;
+      return HAL_ML_ERROR_CANCELED;
+    }
+  }
+
+  memcpy (out->data, in->data, std::min (in->size, out->size));
+  if (priv->flags & LOOPBACK_FLAG_POSITION) {
+    unsigned char *data = static_cast<unsigned char *> (out->data);
+
+    for (size_t i = 0; i < std::min (in->size, out->size); i++)
+      data[i] = (unsigned char) (data[i] + i);
+  }
+  loopback_invoke_count++;
+  loopback_concurrency--;
+
+  {
+    std::lock_guard<std::mutex> lock (loopback_trace_lock);
+    if (loopback_tracing)
+      loopback_trace.push_back ({ in->data, out->data });
+  }
+
+  {
+    std::lock_guard<std::mutex> lock (loopback_affinity_lock);
+    sched_getaffinity (0, sizeof (loopback_last_affinity), &loopback_last_affinity);
+  }
+  return HAL_ML_ERROR_NONE;
+}
+
+static int
+loopback_invoke_dynamic (void *backend_private, void *prop, const void *input, void *output)
+{
+  loopback_private_s *priv = static_cast<loopback_private_s *> (backend_private);
+  const loopback_prop_s *lprop = static_cast<const loopback_prop_s *> (prop);
+
+  /* The new tensor size stands for the changed shape. */
+  if (priv && lprop)
+    priv->tensor_size = lprop->tensor_size;
+
+  return loopback_invoke (backend_private, input, output);
+}
+
+static int
+loopback_get_framework_info (void *backend_private, void *framework_info)
+{
+  return HAL_ML_ERROR_NOT_SUPPORTED;
+}
+
+static int
+loopback_get_model_info (void *backend_private, int ops, void *in_info, void *out_info)
+{
+  return HAL_ML_ERROR_NOT_SUPPORTED;
+}
+
+static int
+loopback_event_handler (void *backend_private, int ops, void *data)
+{
+  return HAL_ML_ERROR_NOT_SUPPORTED;
+}
+
+static int
+loopback_cancel (void *backend_private)
+{
+  loopback_private_s *priv = static_cast<loopback_private_s *> (backend_private);
+
+  if (!priv)
+    return HAL_ML_ERROR_INVALID_PARAMETER;
+
+  std::lock_guard<std::mutex> lock (priv->cancel_lock);
+  if (priv->invoking)
+    priv->canceled = true;
+  return HAL_ML_ERROR_NONE;
+}
+
+static int
+loopback_get_tensors_layout (void *backend_private, hal_ml_tensors_layout_s *in_layout,
+    hal_ml_tensors_layout_s *out_layout)
+{
+  loopback_private_s *priv = static_cast<loopback_private_s *> (backend_private);
+
+  if (!priv || priv->tensor_size == 0)
+    return HAL_ML_ERROR_NOT_SUPPORTED;
+
+  loopback_layout_queries++;
+  in_layout->num_tensors = out_layout->num_tensors = 1;
+  in_layout->size[0] = out_layout->size[0] = priv->tensor_size;
+  return HAL_ML_ERROR_NONE;
+}
+
+static void
+loopback_fill_funcs (hal_backend_ml_funcs *funcs, int (*init) (void **backend_private))
+{
+  funcs->init = init;
+  funcs->deinit = loopback_deinit;
+  funcs->configure_instance = loopback_configure_instance;
+  funcs->invoke = loopback_invoke;
+  funcs->invoke_dynamic = loopback_invoke_dynamic;
+  funcs->get_framework_info = loopback_get_framework_info;
+  funcs->get_model_info = loopback_get_model_info;
+  funcs->event_handler = loopback_event_handler;
+  funcs->cancel = loopback_cancel;
+  funcs->get_tensors_layout = loopback_get_tensors_layout;
+}
+
+typedef struct {
+  const char *name;
+  int (*init) (void **backend_private);
+  hal_backend_ml_funcs *funcs;
+  int refcount;
+} loopback_library_s;
+
+static loopback_library_s loopback_libraries[] = {
+  { LOOPBACK_LIBRARY_NAME, loopback_init, nullptr, 0 },
+  { LOOPBACK_TURBO_LIBRARY_NAME, loopback_turbo_init, nullptr, 0 },
+};
+
+static loopback_library_s *
+loopback_find_library (const char *library_name)
+{
+  for (auto &library : loopback_libraries) {
+    if (strcmp (library_name, library.name) == 0)
+      return &library;
+  }
+
+  return nullptr;
+}
+
+int
+loopback_create (hal_ml_h *ml, unsigned int delay_us)
+{
+  loopback_prop_s prop = { delay_us, 0 };
+  hal_ml_param_h param;
+  int ret;
+
+  ret = hal_ml_create (LOOPBACK_BACKEND_NAME, ml);
+  if (ret != HAL_ML_ERROR_NONE)
+    return ret;
+
+  hal_ml_param_create (&param);
+  hal_ml_param_set (param, "properties", &prop);
+  ret = hal_ml_request (*ml, "configure_instance", param);
+  hal_ml_param_destroy (param);
+
+  if (ret != HAL_ML_ERROR_NONE)
+    hal_ml_destroy (*ml);
+
+  return ret;
+}
+
+int
+loopback_get_live_instances (void)
+{
+  return loopback_live_instances.load ();
+}
+
+int
+loopback_get_library_refcount (void)
+{
+  std::lock_guard<std::mutex> lock (loopback_lock);
+  return loopback_libraries[0].refcount;
+}
+
+unsigned long
+loopback_get_invoke_count (void)
+{
+  return loopback_invoke_count.load ();
+}
+
+unsigned long
+loopback_get_layout_queries (void)
+{
+  return loopback_layout_queries.load ();
+}
+
+void
+loopback_get_last_affinity (cpu_set_t *cpus)
+{
+  std::lock_guard<std::mutex> lock (loopback_affinity_lock);
+  *cpus = loopback_last_affinity;
+}
+
+void
+loopback_trace_start (void)
+{
+  std::lock_guard<std::mutex> lock (loopback_trace_lock);
+  loopback_trace.clear ();
+  loopback_tracing = true;
+  loopback_max_concurrency = loopback_concurrency.load ();
+  loopback_max_live_instances = loopback_live_instances.load ();
+}
+
+size_t
+loopback_trace_get (loopback_trace_s *trace, size_t max)
+{
+  std::lock_guard<std::mutex> lock (loopback_trace_lock);
+  size_t count = std::min (max, loopback_trace.size ());
+
+  std::copy_n (loopback_trace.begin (), count, trace);
+  return loopback_trace.size ();
+}
+
+int
+loopback_trace_get_max_concurrency (void)
+{
+  return loopback_max_concurrency.load ();
+}
+
+int
+loopback_trace_get_max_live_instances (void)
+{
+  return loopback_max_live_instances.load ();
+}
+
+extern "C" {
+
+int
+hal_common_get_backend_count (enum hal_module module)
+{
+  return (module == HAL_MODULE_ML) ? (int) std::size (loopback_libraries) : 0;
+}
+
+int
+hal_common_get_backend_library_names (enum hal_module module,
+    char **library_names, int library_names_size, int library_name_size)
+{
+  if (module != HAL_MODULE_ML || !library_names
+      || library_names_size < (int) std::size (loopback_libraries))
+    return -EINVAL;
+
+  for (size_t i = 0; i < std::size (loopback_libraries); i++)
+    snprintf (library_names[i], library_name_size, "%s", loopback_libraries[i].name);
+  return 0;
+}
+
+int
+hal_common_get_backend_with_library_name_v2 (enum hal_module module,
+    void **data_private, void *user_data,
+    int (*get_backend) (void **data, void *user_data), const char *library_name)
+{
+  if (module != HAL_MODULE_ML || !data_private || !get_backend || !library_name)
+    return -EINVAL;
+
+  loopback_library_s *library = loopback_find_library (library_name);
+  if (!library)
+    return -ENOENT;
+
+  std::lock_guard<std::mutex> lock (loopback_lock);
+  if (library->refcount == 0) {
+    void *data = nullptr;
+
+    if (get_backend (&data, user_data) != 0 || !data)
+      return -ENOMEM;
+
+    library->funcs = static_cast<hal_backend_ml_funcs *> (data);
+    loopback_fill_funcs (library->funcs, library->init);
+  }
+
+  library->refcount++;
+  *data_private = library->funcs;
+  return 0;
+}
+
+int
+hal_common_put_backend_with_library_name_v2 (enum hal_module module,
+    void *data_private, void *user_data,
+    int (*put_backend) (void *data, void *user_data), const char *library_name)
+{
+  if (module != HAL_MODULE_ML || !put_backend || !library_name)
+    return -EINVAL;
+
+  loopback_library_s *library = loopback_find_library (library_name);
+  if (!library)
+    return -ENOENT;
+
+  std::lock_guard<std::mutex> lock (loopback_lock);
+  if (library->refcount <= 0 || data_private != library->funcs)
+    return -EINVAL;
+
+  if (--library->refcount == 0) {
+    put_backend (library->funcs, user_data);
+    library->funcs = nullptr;
+  }
+
+  return 0;
+}
+
+} /* extern "C" */
@@ -0,0 +1,127 @@
+/**
+ * Loopback HAL ML backend for tests
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-loopback.h
+ * @date    18 Oct 2026
+ * @brief   Loopback HAL ML backend for tests
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ *    The loopback backend copies the input tensor into the output tensor.
+ *    It is also installed as the "turbo" backend, which is faster, so tests
+ *    can tell which of several backends hal-api-ml chose.
+ *    It is provided by replacing hal-api-common's backend lookup in the test
+ *    executable, so tests can exercise hal-api-ml without an installed backend.
+ */
+
+#ifndef __ML_HALTESTS_LOOPBACK__
+#define __ML_HALTESTS_LOOPBACK__
+
+#include <sched.h>
+#include <stddef.h>
+#include <hal-ml.h>
+
+/**
+ * @brief The substring of the loopback backend library name for hal_ml_create().
+ */
+#define LOOPBACK_BACKEND_NAME "loopback"
+
+/**
+ * @brief The substring of a second loopback backend, whose invokes take a quarter of the delay.
+ */
+#define LOOPBACK_TURBO_BACKEND_NAME "turbo"
+
+/**
+ * @brief Tensor memory used by the loopback backend (layout of GstTensorMemory).
+ */
+typedef struct {
+  void *data;
+  size_t size;
+} loopback_tensor_s;
+
+/**
+ * @brief Flag of loopback_prop_s to add to each output byte its offset in the tensor, modulo 256.
+ */
+#define LOOPBACK_FLAG_POSITION (1U << 0)
+
+/**
+ * @brief Flag of loopback_prop_s to ignore cancel, like a backend whose invoke cannot be interrupted.
+ */
+#define LOOPBACK_FLAG_NO_CANCEL (1U << 1)
+
+/**
+ * @brief Properties for configure_instance of the loopback backend.
+ */
+typedef struct {
+  unsigned int delay_us; /**< Time to spend in each invoke. The invoke can be canceled meanwhile. */
+  size_t tensor_size; /**< Size of the single input and output tensor for get_tensors_layout, 0 if unknown. */
+  unsigned int flags; /**< LOOPBACK_FLAG_* values. */
+} loopback_prop_s;
+
+/**
+ * @brief Creates a hal-ml handle with the loopback backend and configures it.
+ * @param[out] ml Newly created handle.
+ * @param[in] delay_us Time to spend in each invoke.
+ */
+int loopback_create (hal_ml_h *ml, unsigned int delay_us);
+
+/**
+ * @brief Returns the number of backend instances which are not deinitialized yet.
+ */
+int loopback_get_live_instances (void);
+
+/**
+ * @brief Returns the reference count hal-api-common holds for the loopback library.
+ */
+int loopback_get_library_refcount (void);
+
+/**
+ * @brief Returns the total number of invokes handled by the loopback backend.
+ */
+unsigned long loopback_get_invoke_count (void);
+
+/**
+ * @brief Returns the total number of get_tensors_layout calls to the loopback backend.
+ */
+unsigned long loopback_get_layout_queries (void);
+
+/**
+ * @brief The buffers of an invoke recorded by the loopback backend.
+ */
+typedef struct {
+  const void *input; /**< The data of the first input tensor */
+  void *output; /**< The data of the first output tensor */
+} loopback_trace_s;
+
+/**
+ * @brief Clears the recorded invokes and the peaks of concurrent invokes and instances, and starts recording.
+ */
+void loopback_trace_start (void);
+
+/**
+ * @brief Gets up to @a max invokes recorded since loopback_trace_start(), in the order they finished.
+ * @return The number of invokes recorded.
+ */
+size_t loopback_trace_get (loopback_trace_s *trace, size_t max);
+
+/**
+ * @brief Returns the largest number of invokes running at once since loopback_trace_start().
+ */
+int loopback_trace_get_max_concurrency (void);
+
+/**
+ * @brief Returns the largest number of backend instances alive at once since loopback_trace_start().
+ */
+int loopback_trace_get_max_live_instances (void);
+
+/**
+ * @brief Gets the CPU affinity of the thread which ran the last invoke of the loopback backend.
+ */
+void loopback_get_last_affinity (cpu_set_t *cpus);
+
+#endif /* __ML_HALTESTS_LOOPBACK__ */
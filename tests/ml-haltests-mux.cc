@@ -0,0 +1,157 @@
+/**
+ * Tests for the model multiplexer of HAL ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-mux.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for the model multiplexer of HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "ml-haltests-loopback.h"
+
+static loopback_prop_s mux_prop = { 0 };
+
+static int
+mux_invoke (hal_ml_mux_h mux, const char *model_id)
+{
+  unsigned char in_data[8], out_data[8] = { 0 };
+  loopback_tensor_s in = { in_data, sizeof (in_data) };
+  loopback_tensor_s out = { out_data, sizeof (out_data) };
+  int ret;
+
+  memset (in_data, model_id[0], sizeof (in_data));
+  ret = hal_ml_mux_invoke (mux, model_id, &in, &out);
+  if (ret == HAL_ML_ERROR_NONE && memcmp (in_data, out_data, sizeof (in_data)) != 0)
+    ret = HAL_ML_ERROR_RUNTIME_ERROR;
+
+  return ret;
+}
+
+TEST (HAL_ML_MUX, lru_instances)
+{
+  hal_ml_mux_h mux;
+  hal_ml_mux_stats_s stats;
+
+  ASSERT_EQ (hal_ml_mux_create (LOOPBACK_BACKEND_NAME, 2, 0, &mux), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_add_model (mux, "a", &mux_prop, 10), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_add_model (mux, "b", &mux_prop, 10), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_add_model (mux, "c", &mux_prop, 10), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_add_model (mux, "c", &mux_prop, 10), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (mux_invoke (mux, "unknown"), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  EXPECT_EQ (mux_invoke (mux, "a"), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (mux_invoke (mux, "b"), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (mux_invoke (mux, "c"), HAL_ML_ERROR_NONE); /* evicts a */
+  EXPECT_EQ (mux_invoke (mux, "b"), HAL_ML_ERROR_NONE); /* hit */
+  EXPECT_EQ (mux_invoke (mux, "a"), HAL_ML_ERROR_NONE); /* evicts c */
+  EXPECT_EQ (mux_invoke (mux, "b"), HAL_ML_ERROR_NONE); /* hit */
+
+  EXPECT_EQ (hal_ml_mux_get_stats (mux, &stats), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (stats.misses, 4U);
+  EXPECT_EQ (stats.hits, 2U);
+  EXPECT_EQ (stats.evictions, 2U);
+  EXPECT_EQ (stats.resident, 2U);
+  EXPECT_EQ (stats.memory_used, 20U);
+  EXPECT_EQ (loopback_get_live_instances (), 2);
+
+  EXPECT_EQ (hal_ml_mux_destroy (mux), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (loopback_get_live_instances (), 0);
+}
+
+TEST (HAL_ML_MUX, memory_budget)
+{
+  hal_ml_mux_h mux;
+  hal_ml_mux_stats_s stats;
+
+  ASSERT_EQ (hal_ml_mux_create (LOOPBACK_BACKEND_NAME, 8, 100, &mux), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_add_model (mux, "big", &mux_prop, 200), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_mux_add_model (mux, "a", &mux_prop, 60), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_add_model (mux, "b", &mux_prop, 60), HAL_ML_ERROR_NONE);
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ (mux_invoke (mux, "a"), HAL_ML_ERROR_NONE);
+    EXPECT_EQ (mux_invoke (mux, "b"), HAL_ML_ERROR_NONE);
+  }
+
+  EXPECT_EQ (hal_ml_mux_get_stats (mux, &stats), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (stats.resident, 1U);
+  EXPECT_LE (stats.memory_used, 100U);
+  EXPECT_EQ (stats.misses, 8U);
+
+  EXPECT_EQ (hal_ml_mux_destroy (mux), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_MUX, prefetch)
+{
+  hal_ml_mux_h mux;
+  hal_ml_mux_stats_s stats;
+  const char *sequence[] = { "a", "b", "c" };
+
+  ASSERT_EQ (hal_ml_mux_create (LOOPBACK_BACKEND_NAME, 2, 0, &mux), HAL_ML_ERROR_NONE);
+  for (const char *id : sequence)
+    EXPECT_EQ (hal_ml_mux_add_model (mux, id, &mux_prop, 0), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_set_prefetch (mux, true), HAL_ML_ERROR_NONE);
+
+  /* a -> b -> c -> a ... never fits in two instances without prefetch. */
+  for (int i = 0; i < 30; i++) {
+    EXPECT_EQ (mux_invoke (mux, sequence[i % 3]), HAL_ML_ERROR_NONE);
+    std::this_thread::sleep_for (std::chrono::milliseconds (5));
+  }
+
+  EXPECT_EQ (hal_ml_mux_get_stats (mux, &stats), HAL_ML_ERROR_NONE);
+  EXPECT_GT (stats.prefetches, 0U);
+  EXPECT_GT (stats.prefetch_hits, 0U);
+  EXPECT_GT (stats.hits, 10U);
+
+  EXPECT_EQ (hal_ml_mux_destroy (mux), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (loopback_get_live_instances (), 0);
+}
+
+TEST (HAL_ML_MUX, concurrent_residency)
+{
+  hal_ml_mux_h mux;
+  hal_ml_mux_stats_s stats;
+  const char *models[] = { "a", "b", "c", "d", "e" };
+  std::vector<std::thread> threads;
+  std::atomic<int> failures (0);
+
+  ASSERT_EQ (hal_ml_mux_create (LOOPBACK_BACKEND_NAME, 2, 0, &mux), HAL_ML_ERROR_NONE);
+  for (const char *id : models)
+    EXPECT_EQ (hal_ml_mux_add_model (mux, id, &mux_prop, 0), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_set_prefetch (mux, true), HAL_ML_ERROR_NONE);
+
+  /* Loads and evictions race; an evicted instance still counts until it is destroyed. */
+  loopback_trace_start ();
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back ([&, t] () {
+      for (int i = 0; i < 300; i++) {
+        if (mux_invoke (mux, models[(t + i * (t + 1)) % 5]) != HAL_ML_ERROR_NONE)
+          failures++;
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join ();
+
+  EXPECT_EQ (failures.load (), 0);
+  EXPECT_LE (loopback_trace_get_max_live_instances (), 2);
+  EXPECT_EQ (hal_ml_mux_get_stats (mux, &stats), HAL_ML_ERROR_NONE);
+  EXPECT_GT (stats.evictions, 0U);
+
+  EXPECT_EQ (hal_ml_mux_destroy (mux), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (loopback_get_live_instances (), 0);
+}
@@ -0,0 +1,342 @@
+/**
+ * Tests for the pipeline of HAL ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-pipeline.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for the pipeline of HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ml-haltests-loopback.h"
+
+#define FRAME_SIZE (64)
+#define NUM_FRAMES (200)
+
+/**
+ * @brief Collects the results of a pipeline.
+ */
+typedef struct {
+  std::mutex lock;
+  std::condition_variable cond;
+  std::vector<int> order;
+  size_t compare_size;
+  int mismatches;
+  int errors;
+  const void *last_output;
+} pipeline_results_s;
+
+static void
+pipeline_result_cb (void *frame_data, const hal_ml_tensor_memory_s *output, int result, void *user_data)
+{
+  pipeline_results_s *results = static_cast<pipeline_results_s *> (user_data);
+  int frame = (int) (intptr_t) frame_data;
+  unsigned char expected[FRAME_SIZE];
+
+  std::lock_guard<std::mutex> lock (results->lock);
+  if (result != HAL_ML_ERROR_NONE || !output) {
+    results->errors++;
+  } else {
+    memset (expected, frame & 0xff, sizeof (expected));
+    if (memcmp (output[0].data, expected, results->compare_size) != 0)
+      results->mismatches++;
+  }
+
+  results->last_output = output ? output[0].data : nullptr;
+  results->order.push_back (frame);
+  results->cond.notify_all ();
+}
+
+static void
+pipeline_wait_results (pipeline_results_s *results, size_t count)
+{
+  std::unique_lock<std::mutex> lock (results->lock);
+  results->cond.wait (lock, [&] () { return results->order.size () >= count; });
+}
+
+static int
+pipeline_transform_cb (const hal_ml_tensor_memory_s *prev_output, hal_ml_tensor_memory_s *input, void *user_data)
+{
+  memcpy (input[0].data, prev_output[0].data, input[0].size);
+  return HAL_ML_ERROR_NONE;
+}
+
+TEST (HAL_ML_PIPELINE, cascade)
+{
+  hal_ml_h ml[3];
+  hal_ml_pipeline_h pipe;
+  hal_ml_tensors_layout_s layout = { 0 };
+  pipeline_results_s results;
+  std::vector<std::vector<unsigned char>> data (NUM_FRAMES, std::vector<unsigned char> (FRAME_SIZE));
+  std::vector<hal_ml_tensor_memory_s> inputs (NUM_FRAMES);
+
+  layout.num_tensors = 1;
+  layout.size[0] = FRAME_SIZE;
+  results.compare_size = FRAME_SIZE;
+  results.mismatches = results.errors = 0;
+
+  ASSERT_EQ (hal_ml_pipeline_create (2, &pipe), HAL_ML_ERROR_NONE);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ (loopback_create (&ml[i], 100), HAL_ML_ERROR_NONE);
+    EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml[i], &layout, &layout, nullptr, nullptr), HAL_ML_ERROR_NONE);
+  }
+  EXPECT_EQ (hal_ml_pipeline_set_result_cb (pipe, pipeline_result_cb, &results), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_start (pipe), HAL_ML_ERROR_NONE);
+
+  /* A running pipeline cannot be changed. */
+  EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml[0], &layout, &layout, nullptr, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  for (int f = 0; f < NUM_FRAMES; f++) {
+    memset (data[f].data (), f & 0xff, FRAME_SIZE);
+    inputs[f].data = data[f].data ();
+    inputs[f].size = FRAME_SIZE;
+    EXPECT_EQ (hal_ml_pipeline_push (pipe, &inputs[f], (void *) (intptr_t) f), HAL_ML_ERROR_NONE);
+  }
+
+  pipeline_wait_results (&results, NUM_FRAMES);
+  EXPECT_EQ (hal_ml_pipeline_stop (pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_push (pipe, &inputs[0], nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  EXPECT_EQ (results.errors, 0);
+  EXPECT_EQ (results.mismatches, 0);
+  for (int f = 0; f < NUM_FRAMES; f++)
+    EXPECT_EQ (results.order[f], f);
+
+  EXPECT_EQ (hal_ml_pipeline_destroy (pipe), HAL_ML_ERROR_NONE);
+  for (int i = 0; i < 3; i++)
+    EXPECT_EQ (hal_ml_destroy (ml[i]), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_PIPELINE, transform)
+{
+  hal_ml_h ml[2];
+  hal_ml_pipeline_h pipe;
+  hal_ml_tensors_layout_s big = { 0 }, small = { 0 };
+  pipeline_results_s results;
+  unsigned char data[FRAME_SIZE];
+  hal_ml_tensor_memory_s input = { data, sizeof (data) };
+
+  big.num_tensors = small.num_tensors = 1;
+  big.size[0] = FRAME_SIZE;
+  small.size[0] = FRAME_SIZE / 2;
+  results.compare_size = FRAME_SIZE / 2;
+  results.mismatches = results.errors = 0;
+
+  ASSERT_EQ (loopback_create (&ml[0], 0), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (loopback_create (&ml[1], 0), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_create (1, &pipe), HAL_ML_ERROR_NONE);
+
+  EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml[0], &big, &big, nullptr, nullptr), HAL_ML_ERROR_NONE);
+  /* The layouts do not match without transform. */
+  EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml[1], &small, &small, nullptr, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml[1], &small, &small, pipeline_transform_cb, nullptr), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_set_result_cb (pipe, pipeline_result_cb, &results), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_start (pipe), HAL_ML_ERROR_NONE);
+
+  memset (data, 7, sizeof (data));
+  EXPECT_EQ (hal_ml_pipeline_push (pipe, &input, (void *) (intptr_t) 7), HAL_ML_ERROR_NONE);
+  pipeline_wait_results (&results, 1);
+
+  EXPECT_EQ (results.errors, 0);
+  EXPECT_EQ (results.mismatches, 0);
+
+  EXPECT_EQ (hal_ml_pipeline_destroy (pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_destroy (ml[0]), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_destroy (ml[1]), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_PIPELINE, start_out_of_memory)
+{
+  hal_ml_h ml[2];
+  hal_ml_pipeline_h pipe;
+  hal_ml_tensors_layout_s layout = { 0 }, huge = { 0 };
+  pipeline_results_s results;
+
+  layout.num_tensors = huge.num_tensors = 1;
+  layout.size[0] = FRAME_SIZE;
+  huge.size[0] = SIZE_MAX / 4;
+
+  ASSERT_EQ (loopback_create (&ml[0], 0), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (loopback_create (&ml[1], 0), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_create (2, &pipe), HAL_ML_ERROR_NONE);
+
+  /* The buffers of the first stage are allocated before the transformed input of the second one fails. */
+  EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml[0], &layout, &layout, nullptr, nullptr), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml[1], &huge, &layout, pipeline_transform_cb, nullptr), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_set_result_cb (pipe, pipeline_result_cb, &results), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_start (pipe), HAL_ML_ERROR_OUT_OF_MEMORY);
+  EXPECT_EQ (hal_ml_pipeline_start (pipe), HAL_ML_ERROR_OUT_OF_MEMORY);
+  EXPECT_EQ (hal_ml_pipeline_stop (pipe), HAL_ML_ERROR_NONE);
+
+  EXPECT_EQ (hal_ml_pipeline_destroy (pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_destroy (ml[0]), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_destroy (ml[1]), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_PIPELINE, zero_copy_overlap)
+{
+  hal_ml_h ml[2];
+  hal_ml_pipeline_h pipe;
+  hal_ml_tensors_layout_s layout = { 0 };
+  pipeline_results_s results;
+  unsigned char data[FRAME_SIZE];
+  hal_ml_tensor_memory_s input = { data, sizeof (data) };
+  loopback_trace_s trace[2];
+
+  layout.num_tensors = 1;
+  layout.size[0] = FRAME_SIZE;
+  results.compare_size = FRAME_SIZE;
+  results.mismatches = results.errors = 0;
+
+  ASSERT_EQ (hal_ml_pipeline_create (2, &pipe), HAL_ML_ERROR_NONE);
+  for (int i = 0; i < 2; i++) {
+    ASSERT_EQ (loopback_create (&ml[i], 20000), HAL_ML_ERROR_NONE);
+    EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, ml[i], &layout, &layout, nullptr, nullptr), HAL_ML_ERROR_NONE);
+  }
+  EXPECT_EQ (hal_ml_pipeline_set_result_cb (pipe, pipeline_result_cb, &results), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_start (pipe), HAL_ML_ERROR_NONE);
+
+  /* The input of a stage is the buffer the previous stage wrote, and the result is the last one's. */
+  loopback_trace_start ();
+  memset (data, 0, sizeof (data));
+  EXPECT_EQ (hal_ml_pipeline_push (pipe, &input, (void *) (intptr_t) 0), HAL_ML_ERROR_NONE);
+  pipeline_wait_results (&results, 1);
+
+  ASSERT_EQ (loopback_trace_get (trace, 2), 2U);
+  EXPECT_EQ (trace[0].input, (const void *) data);
+  EXPECT_EQ (trace[1].input, (const void *) trace[0].output);
+  EXPECT_EQ (results.last_output, (const void *) trace[1].output);
+  EXPECT_EQ (loopback_trace_get_max_concurrency (), 1);
+
+  /* With frames in flight, both stages run at once. */
+  for (int f = 1; f <= 6; f++)
+    EXPECT_EQ (hal_ml_pipeline_push (pipe, &input, (void *) (intptr_t) 0), HAL_ML_ERROR_NONE);
+  pipeline_wait_results (&results, 7);
+  EXPECT_EQ (loopback_trace_get_max_concurrency (), 2);
+
+  EXPECT_EQ (results.errors, 0);
+  EXPECT_EQ (results.mismatches, 0);
+
+  EXPECT_EQ (hal_ml_pipeline_destroy (pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_destroy (ml[0]), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_destroy (ml[1]), HAL_ML_ERROR_NONE);
+}
+
+/**
+ * @brief Counts the frames of a pipeline, whose result callback can push the frame again.
+ */
+typedef struct {
+  hal_ml_pipeline_h pipe;
+  hal_ml_h ml[2];
+  hal_ml_tensor_memory_s input;
+  bool repush;
+  std::atomic<int> accepted;
+  std::atomic<int> rejected;
+  std::atomic<int> results;
+} pipeline_loop_s;
+
+static void
+pipeline_loop_cb (void *frame_data, const hal_ml_tensor_memory_s *output, int result, void *user_data)
+{
+  pipeline_loop_s *loop = static_cast<pipeline_loop_s *> (user_data);
+
+  loop->results++;
+  if (!loop->repush)
+    return;
+
+  if (hal_ml_pipeline_push (loop->pipe, &loop->input, nullptr) == HAL_ML_ERROR_NONE)
+    loop->accepted++;
+  else
+    loop->rejected++;
+}
+
+static void
+pipeline_loop_start (pipeline_loop_s *loop, unsigned char *data, bool repush)
+{
+  hal_ml_tensors_layout_s layout = { 0 };
+
+  layout.num_tensors = 1;
+  layout.size[0] = FRAME_SIZE;
+  loop->input.data = data;
+  loop->input.size = FRAME_SIZE;
+  loop->repush = repush;
+  loop->accepted = loop->rejected = loop->results = 0;
+
+  ASSERT_EQ (hal_ml_pipeline_create (2, &loop->pipe), HAL_ML_ERROR_NONE);
+  for (int i = 0; i < 2; i++) {
+    ASSERT_EQ (loopback_create (&loop->ml[i], 500), HAL_ML_ERROR_NONE);
+    EXPECT_EQ (hal_ml_pipeline_add_stage (loop->pipe, loop->ml[i], &layout, &layout, nullptr, nullptr), HAL_ML_ERROR_NONE);
+  }
+  EXPECT_EQ (hal_ml_pipeline_set_result_cb (loop->pipe, pipeline_loop_cb, loop), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_start (loop->pipe), HAL_ML_ERROR_NONE);
+}
+
+static void
+pipeline_loop_destroy (pipeline_loop_s *loop)
+{
+  EXPECT_EQ (hal_ml_pipeline_destroy (loop->pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_destroy (loop->ml[0]), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_destroy (loop->ml[1]), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_PIPELINE, stop_with_callback_push)
+{
+  unsigned char data[FRAME_SIZE] = { 0 };
+  pipeline_loop_s loop;
+
+  pipeline_loop_start (&loop, data, true);
+
+  /* The result callback keeps pushing the frame again while the pipeline stops. */
+  ASSERT_EQ (hal_ml_pipeline_push (loop.pipe, &loop.input, nullptr), HAL_ML_ERROR_NONE);
+  loop.accepted++;
+  std::this_thread::sleep_for (std::chrono::milliseconds (20));
+  EXPECT_EQ (hal_ml_pipeline_stop (loop.pipe), HAL_ML_ERROR_NONE);
+
+  EXPECT_EQ (loop.results.load (), loop.accepted.load ());
+  EXPECT_EQ (loop.rejected.load (), 1);
+
+  pipeline_loop_destroy (&loop);
+}
+
+TEST (HAL_ML_PIPELINE, push_racing_stop)
+{
+  unsigned char data[FRAME_SIZE] = { 0 };
+  pipeline_loop_s loop;
+  std::vector<std::thread> pushers;
+
+  pipeline_loop_start (&loop, data, false);
+
+  for (int t = 0; t < 3; t++) {
+    pushers.emplace_back ([&] () {
+      while (hal_ml_pipeline_push (loop.pipe, &loop.input, nullptr) == HAL_ML_ERROR_NONE)
+        loop.accepted++;
+    });
+  }
+
+  std::this_thread::sleep_for (std::chrono::milliseconds (20));
+  EXPECT_EQ (hal_ml_pipeline_stop (loop.pipe), HAL_ML_ERROR_NONE);
+  for (auto &pusher : pushers)
+    pusher.join ();
+
+  /* Every accepted frame got its result before stop returned. */
+  EXPECT_GT (loop.accepted.load (), 0);
+  EXPECT_EQ (loop.results.load (), loop.accepted.load ());
+
+  pipeline_loop_destroy (&loop);
+}
@@ -0,0 +1,324 @@
+/**
+ * Tests for the CPU and NUMA placement of HAL ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-placement.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for the CPU and NUMA placement of HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ *    The loopback backend records the affinity of the thread running each
+ *    invoke. Tests needing more CPUs than the process may use are skipped.
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "ml-haltests-loopback.h"
+
+#define PLACEMENT_TENSOR_SIZE (64)
+
+/**
+ * @brief Returns the CPUs the calling thread may run on.
+ */
+static std::vector<int>
+allowed_cpus (void)
+{
+  std::vector<int> cpus;
+  cpu_set_t set;
+
+  if (sched_getaffinity (0, sizeof (set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET (cpu, &set))
+        cpus.push_back (cpu);
+    }
+  }
+
+  return cpus;
+}
+
+/**
+ * @brief Invokes @a ml on its worker thread and returns the affinity the invoke ran with.
+ */
+static cpu_set_t
+invoke_on_worker (hal_ml_h ml, const void *input, void *output)
+{
+  cpu_set_t cpus;
+
+  CPU_ZERO (&cpus);
+  if (hal_ml_request_invoke_timeout (ml, input, output, 1000) == HAL_ML_ERROR_NONE)
+    loopback_get_last_affinity (&cpus);
+
+  return cpus;
+}
+
+/**
+ * @brief Fixture with a loopback handle and tensors of one tensor.
+ */
+class HAL_ML_PLACEMENT : public ::testing::Test
+{
+  protected:
+  void SetUp () override
+  {
+    loopback_prop_s prop = { 0, PLACEMENT_TENSOR_SIZE };
+
+    layout.num_tensors = 1;
+    layout.size[0] = PLACEMENT_TENSOR_SIZE;
+
+    ASSERT_EQ (hal_ml_create (LOOPBACK_BACKEND_NAME, &ml), HAL_ML_ERROR_NONE);
+    ASSERT_EQ (hal_ml_request_configure_instance (ml, &prop), HAL_ML_ERROR_NONE);
+    ASSERT_EQ (hal_ml_tensors_alloc (&layout, &input), HAL_ML_ERROR_NONE);
+    ASSERT_EQ (hal_ml_tensors_alloc (&layout, &output), HAL_ML_ERROR_NONE);
+    ASSERT_EQ (sched_getaffinity (0, sizeof (default_cpus), &default_cpus), 0);
+  }
+
+  void TearDown () override
+  {
+    hal_ml_tensors_free (input);
+    hal_ml_tensors_free (output);
+    EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+  }
+
+  hal_ml_h ml = nullptr;
+  hal_ml_tensors_layout_s layout = { 0 };
+  void *input = nullptr;
+  void *output = nullptr;
+  cpu_set_t default_cpus;
+};
+
+TEST_F (HAL_ML_PLACEMENT, worker_thread)
+{
+  std::vector<int> cpus = allowed_cpus ();
+  std::string target = std::to_string (cpus.back ());
+  hal_ml_placement_s placement = { target.c_str (), -1, 0 };
+  hal_ml_placement_stats_s stats;
+  cpu_set_t ran;
+
+  ASSERT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_NONE);
+
+  /* The worker thread of HAL ML moves itself. */
+  ran = invoke_on_worker (ml, input, output);
+  EXPECT_EQ (CPU_COUNT (&ran), 1);
+  EXPECT_TRUE (CPU_ISSET (cpus.back (), &ran));
+
+  /* The thread of the caller is observed, but not moved. */
+  EXPECT_EQ (hal_ml_request_invoke (ml, input, output), HAL_ML_ERROR_NONE);
+  loopback_get_last_affinity (&ran);
+  EXPECT_TRUE (CPU_EQUAL (&ran, &default_cpus));
+
+  EXPECT_EQ (hal_ml_get_placement_stats (ml, &stats), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (stats.invokes, 2U);
+  EXPECT_LE (stats.remote_invokes, stats.invokes);
+
+  /* Without the placement, the worker may run anywhere again. */
+  ASSERT_EQ (hal_ml_set_placement (ml, nullptr), HAL_ML_ERROR_NONE);
+  ran = invoke_on_worker (ml, input, output);
+  EXPECT_TRUE (CPU_EQUAL (&ran, &default_cpus));
+
+  EXPECT_EQ (hal_ml_get_placement_stats (ml, &stats), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (stats.invokes, 0U);
+  EXPECT_EQ (stats.migrations, 0U);
+}
+
+TEST_F (HAL_ML_PLACEMENT, numa_node)
+{
+  hal_ml_placement_s placement = { nullptr, 0, 0 };
+  hal_ml_placement_stats_s stats;
+  hal_ml_tensor_memory_s *local_in, *local_out;
+  void *in, *out, *allocated = nullptr;
+
+  if (access ("/sys/devices/system/node/node0", F_OK) != 0)
+    GTEST_SKIP () << "No NUMA information";
+
+  ASSERT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_NONE);
+
+  /* The buffers are bound to the node and touched before the first invoke. */
+  ASSERT_EQ (hal_ml_tensors_alloc_on_node (&layout, 0, &in), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_tensors_alloc_on_node (&layout, 0, &out), HAL_ML_ERROR_NONE);
+  local_in = static_cast<hal_ml_tensor_memory_s *> (in);
+  local_out = static_cast<hal_ml_tensor_memory_s *> (out);
+  EXPECT_EQ ((uintptr_t) local_in[0].data % 64, 0U);
+  EXPECT_EQ (local_in[0].size, (size_t) PLACEMENT_TENSOR_SIZE);
+  EXPECT_EQ (local_in[1].data, nullptr);
+  EXPECT_EQ (((unsigned char *) local_out[0].data)[PLACEMENT_TENSOR_SIZE - 1], 0);
+
+  memset (local_in[0].data, 0x7e, PLACEMENT_TENSOR_SIZE);
+  invoke_on_worker (ml, in, out);
+  EXPECT_EQ (memcmp (local_in[0].data, local_out[0].data, PLACEMENT_TENSOR_SIZE), 0);
+
+  /* The worker runs on the node of the buffers. */
+  EXPECT_EQ (hal_ml_get_placement_stats (ml, &stats), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (stats.invokes, 1U);
+  EXPECT_EQ (stats.remote_invokes, 0U);
+
+  EXPECT_EQ (hal_ml_request_invoke_alloc (ml, in, &allocated), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (memcmp (local_in[0].data, static_cast<hal_ml_tensor_memory_s *> (allocated)[0].data,
+                 PLACEMENT_TENSOR_SIZE),
+      0);
+
+  hal_ml_tensors_free (allocated);
+  hal_ml_tensors_free (in);
+  hal_ml_tensors_free (out);
+}
+
+TEST_F (HAL_ML_PLACEMENT, isolated)
+{
+  std::vector<int> cpus = allowed_cpus ();
+  std::string list;
+  hal_ml_h other, shared;
+  hal_ml_placement_s placement = { nullptr, -1, 1 };
+  cpu_set_t ran_ml, ran_other, ran_shared;
+
+  if (cpus.size () < 2)
+    GTEST_SKIP () << "Needs 2 CPUs";
+
+  list = std::to_string (cpus[0]) + "," + std::to_string (cpus[1]);
+  placement.cpus = list.c_str ();
+
+  ASSERT_EQ (loopback_create (&other, 0), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (loopback_create (&shared, 0), HAL_ML_ERROR_NONE);
+
+  /* Each isolated thread claims a CPU of its own. */
+  ASSERT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_set_placement (other, &placement), HAL_ML_ERROR_NONE);
+  ran_ml = invoke_on_worker (ml, input, output);
+  ran_other = invoke_on_worker (other, input, output);
+  EXPECT_EQ (CPU_COUNT (&ran_ml), 1);
+  EXPECT_EQ (CPU_COUNT (&ran_other), 1);
+  EXPECT_FALSE (CPU_EQUAL (&ran_ml, &ran_other));
+
+  /* Other placed threads avoid the claimed CPUs, which are released with the handle. */
+  EXPECT_EQ (hal_ml_destroy (other), HAL_ML_ERROR_NONE);
+  placement.isolated = 0;
+  ASSERT_EQ (hal_ml_set_placement (shared, &placement), HAL_ML_ERROR_NONE);
+  ran_shared = invoke_on_worker (shared, input, output);
+  EXPECT_EQ (CPU_COUNT (&ran_shared), 1);
+  EXPECT_FALSE (CPU_EQUAL (&ran_shared, &ran_ml));
+
+  EXPECT_EQ (hal_ml_destroy (shared), HAL_ML_ERROR_NONE);
+}
+
+/**
+ * @brief Counts the results of a pipeline.
+ */
+static void
+placement_result_cb (void *frame_data, const hal_ml_tensor_memory_s *output, int result, void *user_data)
+{
+  std::atomic<int> *done = static_cast<std::atomic<int> *> (user_data);
+
+  if (result == HAL_ML_ERROR_NONE)
+    (*done)++;
+}
+
+TEST_F (HAL_ML_PLACEMENT, pipeline_stage)
+{
+  const int num_frames = 10;
+  std::vector<int> cpus = allowed_cpus ();
+  std::string target = std::to_string (cpus.front ());
+  hal_ml_placement_s placement = { target.c_str (), -1, 0 };
+  hal_ml_placement_stats_s stats;
+  hal_ml_pipeline_h pipe;
+  std::atomic<int> done (0);
+  cpu_set_t ran;
+
+  ASSERT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_create (2, &pipe), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_add_stage (pipe, ml, nullptr, nullptr, nullptr, nullptr), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_set_result_cb (pipe, placement_result_cb, &done), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_start (pipe), HAL_ML_ERROR_NONE);
+
+  for (int f = 0; f < num_frames; f++)
+    EXPECT_EQ (hal_ml_pipeline_push (pipe, static_cast<hal_ml_tensor_memory_s *> (input), nullptr),
+        HAL_ML_ERROR_NONE);
+  while (done.load () < num_frames)
+    std::this_thread::yield ();
+
+  /* The stage thread follows the placement of its handle. */
+  loopback_get_last_affinity (&ran);
+  EXPECT_EQ (CPU_COUNT (&ran), 1);
+  EXPECT_TRUE (CPU_ISSET (cpus.front (), &ran));
+
+  EXPECT_EQ (hal_ml_get_placement_stats (ml, &stats), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (stats.invokes, (uint64_t) num_frames);
+
+  EXPECT_EQ (hal_ml_pipeline_stop (pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_destroy (pipe), HAL_ML_ERROR_NONE);
+}
+
+TEST_F (HAL_ML_PLACEMENT, isolated_thread_exit)
+{
+  std::vector<int> cpus = allowed_cpus ();
+  std::string list;
+  hal_ml_h shared;
+  hal_ml_pipeline_h pipe;
+  hal_ml_placement_s placement = { nullptr, -1, 1 };
+  std::atomic<int> done (0);
+  cpu_set_t ran;
+
+  if (cpus.size () < 2)
+    GTEST_SKIP () << "Needs 2 CPUs";
+
+  list = std::to_string (cpus[0]) + "," + std::to_string (cpus[1]);
+  placement.cpus = list.c_str ();
+
+  /* The stage thread claims a CPU for the isolated placement of the handle. */
+  ASSERT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_create (2, &pipe), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_add_stage (pipe, ml, nullptr, nullptr, nullptr, nullptr), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_set_result_cb (pipe, placement_result_cb, &done), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_pipeline_start (pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_push (pipe, static_cast<hal_ml_tensor_memory_s *> (input), nullptr), HAL_ML_ERROR_NONE);
+  while (done.load () < 1)
+    std::this_thread::yield ();
+  loopback_get_last_affinity (&ran);
+  EXPECT_EQ (CPU_COUNT (&ran), 1);
+
+  /* The claim goes with the thread, while the placement of the handle stays. */
+  EXPECT_EQ (hal_ml_pipeline_stop (pipe), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_pipeline_destroy (pipe), HAL_ML_ERROR_NONE);
+
+  ASSERT_EQ (loopback_create (&shared, 0), HAL_ML_ERROR_NONE);
+  placement.isolated = 0;
+  ASSERT_EQ (hal_ml_set_placement (shared, &placement), HAL_ML_ERROR_NONE);
+  ran = invoke_on_worker (shared, input, output);
+  EXPECT_EQ (CPU_COUNT (&ran), 2);
+
+  EXPECT_EQ (hal_ml_destroy (shared), HAL_ML_ERROR_NONE);
+}
+
+TEST_F (HAL_ML_PLACEMENT, invalid_n)
+{
+  hal_ml_placement_s placement = { "3-1", -1, 0 };
+  hal_ml_placement_stats_s stats;
+  void *tensors;
+
+  EXPECT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_INVALID_PARAMETER);
+  placement.cpus = "0,a";
+  EXPECT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_INVALID_PARAMETER);
+  placement.cpus = "";
+  EXPECT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_INVALID_PARAMETER);
+  placement.cpus = nullptr;
+  placement.numa_node = 1023;
+  EXPECT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_INVALID_PARAMETER);
+  placement.numa_node = -2;
+  EXPECT_EQ (hal_ml_set_placement (ml, &placement), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_tensors_alloc_on_node (&layout, 1023, &tensors), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  /* A failed call keeps the handle without a placement. */
+  EXPECT_EQ (hal_ml_request_invoke (ml, input, output), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_get_placement_stats (ml, &stats), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (stats.invokes, 0U);
+}
@@ -0,0 +1,123 @@
+/**
+ * Tests for the streaming mode of HAL ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-stream.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for the streaming mode of HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "ml-haltests-loopback.h"
+
+#define NUM_FRAMES (100)
+
+/**
+ * @brief Counts the callbacks of a stream.
+ */
+typedef struct {
+  std::atomic<int> invoked;
+  std::atomic<int> canceled;
+  std::atomic<int> mismatches;
+  std::atomic<int> last_invoked;
+} stream_results_s;
+
+static void
+stream_cb (const void *input, void *output, int result, void *frame_data, void *user_data)
+{
+  stream_results_s *results = static_cast<stream_results_s *> (user_data);
+  const loopback_tensor_s *in = static_cast<const loopback_tensor_s *> (input);
+  loopback_tensor_s *out = static_cast<loopback_tensor_s *> (output);
+
+  if (result == HAL_ML_ERROR_CANCELED) {
+    EXPECT_EQ (output, nullptr);
+    results->canceled++;
+    return;
+  }
+
+  EXPECT_EQ (result, HAL_ML_ERROR_NONE);
+  if (memcmp (in->data, out->data, in->size) != 0)
+    results->mismatches++;
+  results->invoked++;
+  results->last_invoked = (int) (intptr_t) frame_data;
+}
+
+/**
+ * @brief Pushes frames faster than the backend and checks every frame is reported once.
+ */
+static void
+stream_run (hal_ml_stream_policy_e policy, unsigned int depth, stream_results_s *results, hal_ml_stream_stats_s *stats)
+{
+  hal_ml_h ml;
+  unsigned char out_data[16];
+  loopback_tensor_s out = { out_data, sizeof (out_data) };
+  std::vector<std::vector<unsigned char>> data (NUM_FRAMES, std::vector<unsigned char> (16));
+  std::vector<loopback_tensor_s> inputs (NUM_FRAMES);
+
+  results->invoked = results->canceled = results->mismatches = 0;
+  results->last_invoked = -1;
+
+  ASSERT_EQ (loopback_create (&ml, 1000), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_stream_start (ml, depth, policy, &out, stream_cb, results), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_stream_start (ml, depth, policy, &out, stream_cb, results), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  for (int f = 0; f < NUM_FRAMES; f++) {
+    memset (data[f].data (), f, 16);
+    inputs[f].data = data[f].data ();
+    inputs[f].size = 16;
+    EXPECT_EQ (hal_ml_stream_push (ml, &inputs[f], (void *) (intptr_t) f), HAL_ML_ERROR_NONE);
+  }
+
+  EXPECT_EQ (hal_ml_stream_stop (ml), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_stream_push (ml, &inputs[0], nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_stream_get_stats (ml, stats), HAL_ML_ERROR_NONE);
+
+  EXPECT_EQ (results->mismatches.load (), 0);
+  EXPECT_EQ (results->invoked.load () + results->canceled.load (), NUM_FRAMES);
+  EXPECT_EQ (stats->pushed, (uint64_t) NUM_FRAMES);
+  EXPECT_EQ (stats->processed, (uint64_t) results->invoked.load ());
+  EXPECT_EQ (stats->dropped, (uint64_t) results->canceled.load ());
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_STREAM, drop_oldest)
+{
+  stream_results_s results;
+  hal_ml_stream_stats_s stats;
+
+  stream_run (HAL_ML_STREAM_POLICY_DROP_OLDEST, 4, &results, &stats);
+  EXPECT_GT (stats.dropped, 0U);
+}
+
+TEST (HAL_ML_STREAM, keep_latest)
+{
+  stream_results_s results;
+  hal_ml_stream_stats_s stats;
+
+  stream_run (HAL_ML_STREAM_POLICY_KEEP_LATEST, 4, &results, &stats);
+  EXPECT_GT (stats.dropped, 0U);
+}
+
+TEST (HAL_ML_STREAM, block)
+{
+  stream_results_s results;
+  hal_ml_stream_stats_s stats;
+
+  stream_run (HAL_ML_STREAM_POLICY_BLOCK, 2, &results, &stats);
+  /* Nothing is dropped while pushing; the frames still queued when stopping are. */
+  EXPECT_GT (stats.dropped, 0U);
+  EXPECT_LE (stats.dropped, 2U);
+  EXPECT_GE (results.last_invoked.load (), NUM_FRAMES - 3);
+}
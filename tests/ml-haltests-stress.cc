@@ -0,0 +1,400 @@
+/**
+ * Concurrency stress and scaling tests for HAL ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-stress.cc
+ * @date    18 Oct 2026
+ * @brief   Concurrency stress and scaling tests for HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ *    Hammers create/destroy/request/invoke from several threads with the
+ *    loopback backend. Build with -DENABLE_TSAN=ON to check the HAL with
+ *    ThreadSanitizer; GLib should be instrumented as well, since its futex
+ *    based GMutex is invisible to ThreadSanitizer otherwise.
+ *    The environment variables below tune the suite.
+ *      HAL_ML_STRESS_MAX_THREADS  : the largest thread count (default: number of CPUs, up to 16)
+ *      HAL_ML_STRESS_ITERATIONS   : iterations per thread (default: 2000)
+ *      HAL_ML_STRESS_MIN_SCALING  : minimum ratio of N-thread to 1-thread throughput (default: not checked)
+ *    The scaling test only reports the throughput unless HAL_ML_STRESS_MIN_SCALING
+ *    is set, since wall-clock numbers are not reliable on shared build machines.
+ *    The overlap test always checks a lenient bound with invokes which sleep in
+ *    the backend, so it holds on a single CPU; HAL_ML_STRESS_MIN_SCALING can
+ *    only tighten it.
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ml-haltests-loopback.h"
+
+/**
+ * @brief Reads a positive integer from the environment.
+ */
+static unsigned int
+stress_env_uint (const char *name, unsigned int default_value)
+{
+  const char *value = getenv (name);
+  if (!value)
+    return default_value;
+
+  unsigned long parsed = strtoul (value, nullptr, 10);
+  return (parsed > 0) ? (unsigned int) parsed : default_value;
+}
+
+/**
+ * @brief Reads a positive real number from the environment.
+ */
+static double
+stress_env_double (const char *name, double default_value)
+{
+  const char *value = getenv (name);
+  if (!value)
+    return default_value;
+
+  double parsed = strtod (value, nullptr);
+  return (parsed > 0.0) ? parsed : default_value;
+}
+
+static unsigned int
+stress_max_threads (void)
+{
+  unsigned int ncpu = std::thread::hardware_concurrency ();
+  ncpu = std::max (1U, std::min (ncpu, 16U));
+  return stress_env_uint ("HAL_ML_STRESS_MAX_THREADS", ncpu);
+}
+
+static unsigned int
+stress_iterations (void)
+{
+  return stress_env_uint ("HAL_ML_STRESS_ITERATIONS", 2000);
+}
+
+/**
+ * @brief Runs @a body on @a num_threads threads, releasing them at once.
+ * @return Elapsed time in seconds.
+ */
+static double
+stress_run_threads (unsigned int num_threads, const std::function<void (unsigned int)> &body)
+{
+  std::vector<std::thread> threads;
+  std::atomic<bool> go (false);
+  std::atomic<unsigned int> ready (0);
+
+  for (unsigned int t = 0; t < num_threads; t++) {
+    threads.emplace_back ([&, t] () {
+      ready++;
+      while (!go.load ())
+        std::this_thread::yield ();
+      body (t);
+    });
+  }
+
+  while (ready.load () < num_threads)
+    std::this_thread::yield ();
+
+  auto start = std::chrono::steady_clock::now ();
+  go = true;
+  for (auto &th : threads)
+    th.join ();
+  auto end = std::chrono::steady_clock::now ();
+
+  return std::chrono::duration<double> (end - start).count ();
+}
+
+/**
+ * @brief Invokes @a ml once with a thread-specific pattern and checks the output.
+ */
+static bool
+stress_invoke_and_check (hal_ml_h ml, unsigned int seed, bool use_request)
+{
+  unsigned char in_data[64];
+  unsigned char out_data[64];
+  loopback_tensor_s in = { in_data, sizeof (in_data) };
+  loopback_tensor_s out = { out_data, sizeof (out_data) };
+
+  memset (in_data, (int) (seed & 0xff), sizeof (in_data));
+  memset (out_data, 0, sizeof (out_data));
+
+  if (use_request) {
+    hal_ml_param_h param;
+    if (hal_ml_param_create (&param) != HAL_ML_ERROR_NONE)
+      return false;
+
+    hal_ml_param_set (param, "input", &in);
+    hal_ml_param_set (param, "output", &out);
+    int ret = hal_ml_request (ml, "invoke", param);
+    hal_ml_param_destroy (param);
+
+    if (ret != HAL_ML_ERROR_NONE)
+      return false;
+  } else {
+    if (hal_ml_request_invoke (ml, &in, &out) != HAL_ML_ERROR_NONE)
+      return false;
+  }
+
+  return memcmp (in_data, out_data, sizeof (in_data)) == 0;
+}
+
+/**
+ * @brief All threads create their first handle at the same time, racing the backend scan.
+ */
+TEST (HAL_ML_STRESS, concurrent_first_create)
+{
+  const unsigned int num_threads = stress_max_threads ();
+  std::atomic<int> failures (0);
+
+  stress_run_threads (num_threads, [&] (unsigned int t) {
+    hal_ml_h ml;
+    if (hal_ml_create (LOOPBACK_BACKEND_NAME, &ml) != HAL_ML_ERROR_NONE) {
+      failures++;
+      return;
+    }
+    if (hal_ml_destroy (ml) != HAL_ML_ERROR_NONE)
+      failures++;
+  });
+
+  EXPECT_EQ (failures.load (), 0);
+  EXPECT_EQ (loopback_get_live_instances (), 0);
+}
+
+/**
+ * @brief Creates and destroys handles from all threads; the backend references must balance.
+ */
+TEST (HAL_ML_STRESS, create_destroy)
+{
+  const unsigned int num_threads = stress_max_threads ();
+  const unsigned int iterations = stress_iterations () / 4;
+  std::atomic<int> failures (0);
+
+  /* Make sure the library is cached, then remember the baseline reference count. */
+  hal_ml_h ml;
+  ASSERT_EQ (hal_ml_create (LOOPBACK_BACKEND_NAME, &ml), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+  const int baseline = loopback_get_library_refcount ();
+
+  stress_run_threads (num_threads, [&] (unsigned int t) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      hal_ml_h h;
+      if (hal_ml_create (LOOPBACK_BACKEND_NAME, &h) != HAL_ML_ERROR_NONE) {
+        failures++;
+        continue;
+      }
+      if (hal_ml_destroy (h) != HAL_ML_ERROR_NONE)
+        failures++;
+    }
+  });
+
+  EXPECT_EQ (failures.load (), 0);
+  EXPECT_EQ (loopback_get_live_instances (), 0);
+  EXPECT_EQ (loopback_get_library_refcount (), baseline);
+}
+
+/**
+ * @brief Each thread owns a handle and mixes hal_ml_request() and hal_ml_request_invoke().
+ */
+TEST (HAL_ML_STRESS, request_invoke)
+{
+  const unsigned int num_threads = stress_max_threads ();
+  const unsigned int iterations = stress_iterations ();
+  std::atomic<int> failures (0);
+  const unsigned long invoked = loopback_get_invoke_count ();
+
+  stress_run_threads (num_threads, [&] (unsigned int t) {
+    hal_ml_h ml;
+    if (loopback_create (&ml, 0) != HAL_ML_ERROR_NONE) {
+      failures++;
+      return;
+    }
+
+    for (unsigned int i = 0; i < iterations; i++) {
+      if (!stress_invoke_and_check (ml, t * 31 + i, (i % 2) == 0))
+        failures++;
+    }
+
+    if (hal_ml_destroy (ml) != HAL_ML_ERROR_NONE)
+      failures++;
+  });
+
+  EXPECT_EQ (failures.load (), 0);
+  EXPECT_EQ (loopback_get_invoke_count () - invoked, (unsigned long) num_threads * iterations);
+  EXPECT_EQ (loopback_get_live_instances (), 0);
+}
+
+/**
+ * @brief Several threads share one handle while other threads churn create/destroy.
+ */
+TEST (HAL_ML_STRESS, shared_handle_with_churn)
+{
+  const unsigned int num_threads = std::max (2U, stress_max_threads ());
+  const unsigned int iterations = stress_iterations () / 2;
+  std::atomic<int> failures (0);
+  hal_ml_h shared;
+
+  ASSERT_EQ (loopback_create (&shared, 0), HAL_ML_ERROR_NONE);
+
+  stress_run_threads (num_threads, [&] (unsigned int t) {
+    for (unsigned int i = 0; i < iterations; i++) {
+      if (t % 2 == 0) {
+        if (!stress_invoke_and_check (shared, t + i, false))
+          failures++;
+      } else {
+        hal_ml_h h;
+        if (loopback_create (&h, 0) != HAL_ML_ERROR_NONE) {
+          failures++;
+          continue;
+        }
+        if (!stress_invoke_and_check (h, t + i, true))
+          failures++;
+        hal_ml_destroy (h);
+      }
+    }
+  });
+
+  EXPECT_EQ (failures.load (), 0);
+  EXPECT_EQ (hal_ml_destroy (shared), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (loopback_get_live_instances (), 0);
+}
+
+/**
+ * @brief Measures throughput for 1..N threads and reports it per thread count.
+ *        The scaling is checked only if HAL_ML_STRESS_MIN_SCALING is set.
+ */
+TEST (HAL_ML_STRESS, scaling)
+{
+  const unsigned int max_threads = stress_max_threads ();
+  const unsigned int iterations = stress_iterations ();
+  const double min_scaling = stress_env_double ("HAL_ML_STRESS_MIN_SCALING", 0.0);
+  double invoke_base = 0.0;
+  double create_base = 0.0;
+
+  std::cout << std::setw (8) << "threads" << std::setw (20) << "invoke (ops/s)"
+            << std::setw (24) << "create+destroy (ops/s)" << std::endl;
+
+  std::vector<unsigned int> thread_counts;
+  for (unsigned int n = 1; n < max_threads; n *= 2)
+    thread_counts.push_back (n);
+  thread_counts.push_back (max_threads);
+
+  for (unsigned int n : thread_counts) {
+    std::atomic<int> failures (0);
+    std::vector<hal_ml_h> handles (n);
+
+    for (unsigned int t = 0; t < n; t++)
+      ASSERT_EQ (loopback_create (&handles[t], 0), HAL_ML_ERROR_NONE);
+
+    double invoke_sec = stress_run_threads (n, [&] (unsigned int t) {
+      for (unsigned int i = 0; i < iterations; i++) {
+        if (!stress_invoke_and_check (handles[t], t + i, false))
+          failures++;
+      }
+    });
+
+    for (unsigned int t = 0; t < n; t++)
+      EXPECT_EQ (hal_ml_destroy (handles[t]), HAL_ML_ERROR_NONE);
+
+    double create_sec = stress_run_threads (n, [&] (unsigned int t) {
+      for (unsigned int i = 0; i < iterations / 4; i++) {
+        hal_ml_h h;
+        if (hal_ml_create (LOOPBACK_BACKEND_NAME, &h) != HAL_ML_ERROR_NONE) {
+          failures++;
+          continue;
+        }
+        hal_ml_destroy (h);
+      }
+    });
+
+    EXPECT_EQ (failures.load (), 0);
+
+    double invoke_ops = (double) n * iterations / invoke_sec;
+    double create_ops = (double) n * (iterations / 4) / create_sec;
+
+    std::cout << std::setw (8) << n << std::setw (20) << std::fixed
+              << std::setprecision (0) << invoke_ops << std::setw (24)
+              << create_ops << std::endl;
+    RecordProperty ("invoke_ops_" + std::to_string (n), (int) invoke_ops);
+    RecordProperty ("create_ops_" + std::to_string (n), (int) create_ops);
+
+    if (n == 1) {
+      invoke_base = invoke_ops;
+      create_base = create_ops;
+    } else if (min_scaling > 0.0) {
+      /* Adding threads must not collapse the aggregate throughput. */
+      EXPECT_GE (invoke_ops, invoke_base * min_scaling) << n << " threads";
+      EXPECT_GE (create_ops, create_base * min_scaling) << n << " threads";
+    }
+  }
+
+  EXPECT_EQ (loopback_get_live_instances (), 0);
+}
+
+/**
+ * @brief Checks that invokes of separate handles overlap, i.e. the invoke path is not serialized.
+ * @details The loopback backend sleeps in each invoke, so the threads overlap even on a single CPU.
+ */
+TEST (HAL_ML_STRESS, invoke_overlap)
+{
+  const unsigned int num_threads = 4;
+  const unsigned int iterations = 50;
+  const double min_scaling = std::max (1.5, stress_env_double ("HAL_ML_STRESS_MIN_SCALING", 0.0));
+  double ops[2];
+
+  for (unsigned int run = 0; run < 2; run++) {
+    unsigned int n = (run == 0) ? 1 : num_threads;
+    std::atomic<int> failures (0);
+    std::vector<hal_ml_h> handles (n);
+
+    for (unsigned int t = 0; t < n; t++)
+      ASSERT_EQ (loopback_create (&handles[t], 1000U), HAL_ML_ERROR_NONE);
+
+    double sec = stress_run_threads (n, [&] (unsigned int t) {
+      for (unsigned int i = 0; i < iterations; i++) {
+        if (!stress_invoke_and_check (handles[t], t + i, false))
+          failures++;
+      }
+    });
+
+    for (unsigned int t = 0; t < n; t++)
+      EXPECT_EQ (hal_ml_destroy (handles[t]), HAL_ML_ERROR_NONE);
+
+    EXPECT_EQ (failures.load (), 0);
+    ops[run] = (double) n * iterations / sec;
+  }
+
+  EXPECT_GE (ops[1], ops[0] * min_scaling) << num_threads << " threads: " << ops[1] << " ops/s, 1 thread: " << ops[0] << " ops/s";
+}
+
+int main (int argc, char *argv[])
+{
+  int ret = -1;
+
+  try {
+    testing::InitGoogleTest (&argc, argv);
+  } catch(...) {
+    std::cout << "Exception occurred." << std::endl;
+  }
+
+  try {
+    ret = RUN_ALL_TESTS ();
+  } catch (const ::testing::internal::GoogleTestFailureException& e) {
+    ret = -1;
+    std::cout << "GoogleTestFailureException was thrown:" << e.what () << std::endl;
+  }
+
+  return ret;
+}
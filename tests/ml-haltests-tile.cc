@@ -0,0 +1,266 @@
+/**
+ * Tests for the tiled invoke of HAL ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-tile.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for the tiled invoke of HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ *
+ * @details
+ *    The loopback backend copies its input, which is a spatially local model
+ *    without context: the stitched output should equal the input exactly.
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "ml-haltests-loopback.h"
+
+static hal_ml_h
+create_with_size (unsigned int delay_us, size_t tensor_size, unsigned int flags = 0)
+{
+  hal_ml_h ml = nullptr;
+  loopback_prop_s prop = { delay_us, tensor_size, flags };
+
+  if (hal_ml_create (LOOPBACK_BACKEND_NAME, &ml) != HAL_ML_ERROR_NONE)
+    return nullptr;
+  if (hal_ml_request_configure_instance (ml, &prop) != HAL_ML_ERROR_NONE) {
+    hal_ml_destroy (ml);
+    return nullptr;
+  }
+
+  return ml;
+}
+
+static std::vector<unsigned char>
+pattern (size_t size)
+{
+  std::vector<unsigned char> data (size);
+
+  for (size_t i = 0; i < size; i++)
+    data[i] = (unsigned char) (i * 7 + i / 251);
+
+  return data;
+}
+
+TEST (HAL_ML_TILE, overlap)
+{
+  hal_ml_tiling_s tiling = { 1, 100, 4, 4, 16, 3, 3 };
+  std::vector<unsigned char> in_data = pattern (100 * 4), out_data (in_data.size ());
+  loopback_tensor_s in[2] = { { in_data.data (), in_data.size () }, { nullptr, 0 } };
+  loopback_tensor_s out[2] = { { out_data.data (), out_data.size () }, { nullptr, 0 } };
+  hal_ml_h ml = create_with_size (0, (16 + 2 * 3) * 4);
+  unsigned long invoked = loopback_get_invoke_count ();
+
+  ASSERT_NE (ml, nullptr);
+
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &tiling, in, out), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (out_data, in_data);
+  EXPECT_EQ (loopback_get_invoke_count () - invoked, 7UL);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TILE, outer_slices)
+{
+  /* Three slices of 50 steps of 2 bytes, e.g. a CHW image tiled along H. */
+  hal_ml_tiling_s tiling = { 3, 50, 2, 2, 10, 2, 2 };
+  std::vector<unsigned char> in_data = pattern (3 * 50 * 2), out_data (in_data.size ());
+  loopback_tensor_s in[2] = { { in_data.data (), in_data.size () }, { nullptr, 0 } };
+  loopback_tensor_s out[2] = { { out_data.data (), out_data.size () }, { nullptr, 0 } };
+  hal_ml_h ml = create_with_size (0, 3 * (10 + 2 * 2) * 2);
+  unsigned long invoked = loopback_get_invoke_count ();
+
+  ASSERT_NE (ml, nullptr);
+
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &tiling, in, out), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (out_data, in_data);
+  EXPECT_EQ (loopback_get_invoke_count () - invoked, 5UL);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TILE, without_layout)
+{
+  /* The last tile is partial and the tiles have no overlap. */
+  hal_ml_tiling_s tiling = { 1, 70, 8, 8, 16, 0, 4 };
+  std::vector<unsigned char> in_data = pattern (70 * 8), out_data (in_data.size ());
+  loopback_tensor_s in[2] = { { in_data.data (), in_data.size () }, { nullptr, 0 } };
+  loopback_tensor_s out[2] = { { out_data.data (), out_data.size () }, { nullptr, 0 } };
+  hal_ml_h ml = create_with_size (0, 0);
+  unsigned long invoked = loopback_get_invoke_count ();
+
+  ASSERT_NE (ml, nullptr);
+
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &tiling, in, out), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (out_data, in_data);
+  EXPECT_EQ (loopback_get_invoke_count () - invoked, 5UL);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TILE, cancel)
+{
+  hal_ml_tiling_s tiling = { 1, 64, 4, 4, 4, 0, 2 };
+  std::vector<unsigned char> in_data = pattern (64 * 4), out_data (in_data.size ());
+  loopback_tensor_s in[2] = { { in_data.data (), in_data.size () }, { nullptr, 0 } };
+  loopback_tensor_s out[2] = { { out_data.data (), out_data.size () }, { nullptr, 0 } };
+  hal_ml_h ml = create_with_size (50000U, 4 * 4);
+  unsigned long invoked = loopback_get_invoke_count ();
+
+  ASSERT_NE (ml, nullptr);
+
+  auto tiled = std::async (std::launch::async, [&] () {
+    return hal_ml_request_invoke_tiled (ml, &tiling, in, out);
+  });
+
+  std::this_thread::sleep_for (std::chrono::milliseconds (80));
+  EXPECT_EQ (hal_ml_request_cancel (ml), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (tiled.get (), HAL_ML_ERROR_CANCELED);
+  EXPECT_LT (loopback_get_invoke_count () - invoked, 16UL);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TILE, cancel_between_tiles)
+{
+  /* One tile at a time on a backend which finishes the running tile despite the cancel. */
+  hal_ml_tiling_s tiling = { 1, 64, 4, 4, 4, 0, 1 };
+  std::vector<unsigned char> in_data = pattern (64 * 4), out_data (in_data.size ());
+  loopback_tensor_s in[2] = { { in_data.data (), in_data.size () }, { nullptr, 0 } };
+  loopback_tensor_s out[2] = { { out_data.data (), out_data.size () }, { nullptr, 0 } };
+  hal_ml_h ml = create_with_size (50000U, 4 * 4, LOOPBACK_FLAG_NO_CANCEL);
+  unsigned long invoked = loopback_get_invoke_count ();
+
+  ASSERT_NE (ml, nullptr);
+
+  auto tiled = std::async (std::launch::async, [&] () {
+    return hal_ml_request_invoke_tiled (ml, &tiling, in, out);
+  });
+
+  std::this_thread::sleep_for (std::chrono::milliseconds (80));
+  EXPECT_EQ (hal_ml_request_cancel (ml), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (tiled.get (), HAL_ML_ERROR_CANCELED);
+  EXPECT_LT (loopback_get_invoke_count () - invoked, 16UL);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+/**
+ * @brief Returns what the loopback backend with LOOPBACK_FLAG_POSITION stitches for @a input.
+ * @details Each output byte depends on its offset in the window, so a wrong window or skip shows.
+ */
+static std::vector<unsigned char>
+expected_positions (const hal_ml_tiling_s &tiling, const std::vector<unsigned char> &input)
+{
+  std::vector<unsigned char> expected (input.size ());
+  size_t window = tiling.tile + 2 * tiling.overlap;
+
+  for (size_t core = 0; core < tiling.length; core += tiling.tile) {
+    /* The window is shifted inwards at the edges of the input. */
+    size_t start = std::min ((core > tiling.overlap) ? core - tiling.overlap : 0, tiling.length - window);
+
+    for (size_t o = 0; o < tiling.outer; o++) {
+      for (size_t step = core; step < std::min (core + tiling.tile, tiling.length); step++) {
+        for (size_t b = 0; b < tiling.in_stride; b++) {
+          size_t index = (o * tiling.length + step) * tiling.in_stride + b;
+          size_t offset = (o * window + step - start) * tiling.in_stride + b;
+
+          expected[index] = (unsigned char) (input[index] + offset);
+        }
+      }
+    }
+  }
+
+  return expected;
+}
+
+TEST (HAL_ML_TILE, window_positions)
+{
+  /* Shifted windows at both edges, a partial last tile and slices copied into the windows. */
+  hal_ml_tiling_s tilings[] = {
+    { 1, 70, 4, 4, 16, 0, 3 },
+    { 1, 47, 2, 2, 10, 3, 2 },
+    { 2, 47, 3, 3, 10, 3, 2 },
+  };
+
+  for (const hal_ml_tiling_s &tiling : tilings) {
+    size_t window = tiling.tile + 2 * tiling.overlap;
+    std::vector<unsigned char> in_data = pattern (tiling.outer * tiling.length * tiling.in_stride);
+    std::vector<unsigned char> out_data (in_data.size ());
+    loopback_tensor_s in[2] = { { in_data.data (), in_data.size () }, { nullptr, 0 } };
+    loopback_tensor_s out[2] = { { out_data.data (), out_data.size () }, { nullptr, 0 } };
+    hal_ml_h ml = create_with_size (0, tiling.outer * window * tiling.in_stride, LOOPBACK_FLAG_POSITION);
+
+    ASSERT_NE (ml, nullptr);
+
+    EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &tiling, in, out), HAL_ML_ERROR_NONE);
+    EXPECT_EQ (out_data, expected_positions (tiling, in_data)) << "outer " << tiling.outer << ", length " << tiling.length;
+
+    EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+  }
+}
+
+TEST (HAL_ML_TILE, layout_mismatch_n)
+{
+  hal_ml_tiling_s tiling = { 1, 100, 4, 4, 16, 3, 3 };
+  std::vector<unsigned char> in_data (100 * 4), out_data (in_data.size ());
+  loopback_tensor_s in[2] = { { in_data.data (), in_data.size () }, { nullptr, 0 } };
+  loopback_tensor_s out[2] = { { out_data.data (), out_data.size () }, { nullptr, 0 } };
+  hal_ml_h ml = create_with_size (0, 16 * 4);
+  unsigned long invoked = loopback_get_invoke_count ();
+
+  ASSERT_NE (ml, nullptr);
+
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &tiling, in, out), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (loopback_get_invoke_count (), invoked);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TILE, invalid_n)
+{
+  hal_ml_tiling_s tiling = { 1, 32, 4, 4, 8, 2, 2 };
+  hal_ml_tiling_s bad;
+  std::vector<unsigned char> in_data (32 * 4), out_data (in_data.size ());
+  loopback_tensor_s in[2] = { { in_data.data (), in_data.size () }, { nullptr, 0 } };
+  loopback_tensor_s out[2] = { { out_data.data (), out_data.size () }, { nullptr, 0 } };
+  loopback_tensor_s two[3] = { { in_data.data (), in_data.size () }, { in_data.data (), 4 }, { nullptr, 0 } };
+  loopback_tensor_s short_in[2] = { { in_data.data (), in_data.size () - 1 }, { nullptr, 0 } };
+  hal_ml_h ml = create_with_size (0, 0);
+
+  ASSERT_NE (ml, nullptr);
+
+  bad = tiling;
+  bad.tile = 0;
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &bad, in, out), HAL_ML_ERROR_INVALID_PARAMETER);
+  bad = tiling;
+  bad.in_flight = 0;
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &bad, in, out), HAL_ML_ERROR_INVALID_PARAMETER);
+  bad = tiling;
+  bad.overlap = 13;
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &bad, in, out), HAL_ML_ERROR_INVALID_PARAMETER);
+  bad = tiling;
+  bad.overlap = SIZE_MAX / 2;
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &bad, in, out), HAL_ML_ERROR_INVALID_PARAMETER);
+  bad = tiling;
+  bad.in_stride = SIZE_MAX / 16;
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &bad, in, out), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &tiling, short_in, out), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &tiling, two, out), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_request_invoke_tiled (ml, &tiling, in, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
@@ -0,0 +1,166 @@
+/**
+ * Tests for invoke timeouts and cancellation of HAL ML
+ *
+ * Copyright (C) 2025 Yongjoo Ahn <yongjoo1.ahn@samsung.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * @file    ml-haltests-timeout.cc
+ * @date    18 Oct 2026
+ * @brief   Tests for invoke timeouts and cancellation of HAL ML
+ * @see     https://github.com/nnstreamer/nnstreamer
+ * @bug     No known bugs except for NYI items
+ */
+
+#include <gtest/gtest.h>
+#include <hal-ml.h>
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
+
+#include "ml-haltests-loopback.h"
+
+static double
+elapsed_ms (std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+}
+
+TEST (HAL_ML_TIMEOUT, invoke_in_time)
+{
+  hal_ml_h ml;
+  unsigned char in_data[16], out_data[16] = { 0 };
+  loopback_tensor_s in = { in_data, sizeof (in_data) };
+  loopback_tensor_s out = { out_data, sizeof (out_data) };
+
+  memset (in_data, 0x5a, sizeof (in_data));
+  ASSERT_EQ (loopback_create (&ml, 0), HAL_ML_ERROR_NONE);
+
+  EXPECT_EQ (hal_ml_request_invoke_timeout (ml, &in, &out, 1000), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (memcmp (in_data, out_data, sizeof (in_data)), 0);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TIMEOUT, running_invoke_is_canceled)
+{
+  hal_ml_h ml;
+  unsigned char data[16] = { 0 };
+  loopback_tensor_s in = { data, sizeof (data) };
+  loopback_tensor_s out = { data, sizeof (data) };
+
+  ASSERT_EQ (loopback_create (&ml, 5000000U), HAL_ML_ERROR_NONE);
+
+  auto start = std::chrono::steady_clock::now ();
+  EXPECT_EQ (hal_ml_request_invoke_timeout (ml, &in, &out, 50), HAL_ML_ERROR_TIMED_OUT);
+  EXPECT_LT (elapsed_ms (start), 2000.0);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TIMEOUT, uncanceled_invoke_completes)
+{
+  hal_ml_h ml;
+  unsigned char in_data[16], out_data[16] = { 0 };
+  loopback_tensor_s in = { in_data, sizeof (in_data) };
+  loopback_tensor_s out = { out_data, sizeof (out_data) };
+  loopback_prop_s prop = { 100000U, 0, LOOPBACK_FLAG_NO_CANCEL };
+
+  memset (in_data, 0x6b, sizeof (in_data));
+  ASSERT_EQ (hal_ml_create (LOOPBACK_BACKEND_NAME, &ml), HAL_ML_ERROR_NONE);
+  ASSERT_EQ (hal_ml_request_configure_instance (ml, &prop), HAL_ML_ERROR_NONE);
+
+  /* The backend finishes the invoke despite the cancel, so its output is valid. */
+  EXPECT_EQ (hal_ml_request_invoke_timeout (ml, &in, &out, 20), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (memcmp (in_data, out_data, sizeof (in_data)), 0);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TIMEOUT, queued_invoke_is_dropped)
+{
+  hal_ml_h ml;
+  unsigned char data[2][16] = { { 0 } };
+  loopback_tensor_s t0 = { data[0], sizeof (data[0]) };
+  loopback_tensor_s t1 = { data[1], sizeof (data[1]) };
+
+  ASSERT_EQ (loopback_create (&ml, 300000U), HAL_ML_ERROR_NONE);
+
+  auto first = std::async (std::launch::async, [&] () {
+    return hal_ml_request_invoke_timeout (ml, &t0, &t0, 5000);
+  });
+  std::this_thread::sleep_for (std::chrono::milliseconds (50));
+
+  const unsigned long invoked = loopback_get_invoke_count ();
+  auto start = std::chrono::steady_clock::now ();
+  EXPECT_EQ (hal_ml_request_invoke_timeout (ml, &t1, &t1, 20), HAL_ML_ERROR_TIMED_OUT);
+  EXPECT_LT (elapsed_ms (start), 250.0);
+
+  EXPECT_EQ (first.get (), HAL_ML_ERROR_NONE);
+  /* The second request never reached the backend. */
+  EXPECT_EQ (loopback_get_invoke_count () - invoked, 1UL);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TIMEOUT, cancel)
+{
+  hal_ml_h ml;
+  unsigned char data[2][16] = { { 0 } };
+  loopback_tensor_s t0 = { data[0], sizeof (data[0]) };
+  loopback_tensor_s t1 = { data[1], sizeof (data[1]) };
+
+  ASSERT_EQ (loopback_create (&ml, 5000000U), HAL_ML_ERROR_NONE);
+
+  auto running = std::async (std::launch::async, [&] () {
+    return hal_ml_request_invoke_timeout (ml, &t0, &t0, 10000);
+  });
+  std::this_thread::sleep_for (std::chrono::milliseconds (50));
+  auto queued = std::async (std::launch::async, [&] () {
+    return hal_ml_request_invoke_timeout (ml, &t1, &t1, 10000);
+  });
+  std::this_thread::sleep_for (std::chrono::milliseconds (50));
+
+  auto start = std::chrono::steady_clock::now ();
+  EXPECT_EQ (hal_ml_request_cancel (ml), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (queued.get (), HAL_ML_ERROR_CANCELED);
+  EXPECT_EQ (running.get (), HAL_ML_ERROR_CANCELED);
+  EXPECT_LT (elapsed_ms (start), 2000.0);
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_TIMEOUT, next_invoke_after_timeout)
+{
+  hal_ml_h ml;
+  unsigned char data[2][16];
+  loopback_tensor_s t0[2] = { { data[0], sizeof (data[0]) }, { nullptr, 0 } };
+  loopback_tensor_s t1[2] = { { data[1], sizeof (data[1]) }, { nullptr, 0 } };
+
+  /* The invoke ends about when it times out, so the cancel often arrives after it has finished. */
+  ASSERT_EQ (loopback_create (&ml, 1000U), HAL_ML_ERROR_NONE);
+
+  for (int i = 0; i < 50; i++) {
+    unsigned char in_data[16], out_data[16] = { 0 };
+    loopback_tensor_s in[2] = { { in_data, sizeof (in_data) }, { nullptr, 0 } };
+    loopback_tensor_s out[2] = { { out_data, sizeof (out_data) }, { nullptr, 0 } };
+
+    memset (in_data, i, sizeof (in_data));
+
+    auto timed_out = std::async (std::launch::async, [&] () {
+      return hal_ml_request_invoke_timeout (ml, t0, t1, 1);
+    });
+    auto next = std::async (std::launch::async, [&] () {
+      return hal_ml_request_invoke_timeout (ml, in, out, 10000);
+    });
+
+    int ret = timed_out.get ();
+    EXPECT_TRUE (ret == HAL_ML_ERROR_NONE || ret == HAL_ML_ERROR_TIMED_OUT) << ret;
+    EXPECT_EQ (next.get (), HAL_ML_ERROR_NONE) << "iteration " << i;
+    EXPECT_EQ (memcmp (in_data, out_data, sizeof (in_data)), 0);
+  }
+
+  EXPECT_EQ (hal_ml_destroy (ml), HAL_ML_ERROR_NONE);
+}
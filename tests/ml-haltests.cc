@@ -61,6 +61,170 @@ TEST (HAL_ML, request_n)
   EXPECT_EQ (hal_ml_param_destroy (param), HAL_ML_ERROR_NONE);
 }
 
+TEST (HAL_ML, request_invoke_timeout_n)
+{
+  EXPECT_EQ (hal_ml_request_invoke_timeout (nullptr, nullptr, nullptr, 100), HAL_ML_ERROR_INVALID_PARAMETER);
+}
+
+TEST (HAL_ML, request_cancel_n)
+{
+  EXPECT_EQ (hal_ml_request_cancel (nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+}
+
+TEST (HAL_ML, request_typed_n)
+{
+  int data = 0;
+
+  EXPECT_EQ (hal_ml_request_configure_instance (nullptr, &data), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_request_invoke_dynamic (nullptr, &data, &data, &data), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_request_get_framework_info (nullptr, &data), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_request_get_model_info (nullptr, 0, &data, &data), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_request_event_handler (nullptr, 0, &data), HAL_ML_ERROR_INVALID_PARAMETER);
+}
+
+TEST (HAL_ML, tensors_layout_n)
+{
+  hal_ml_tensors_layout_s layout = { 0 };
+  void *tensors = nullptr;
+
+  EXPECT_EQ (hal_ml_get_tensors_layout (nullptr, &layout, &layout), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_tensors_alloc (&layout, &tensors), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_tensors_alloc (nullptr, &tensors), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_request_invoke_alloc (nullptr, &layout, &tensors), HAL_ML_ERROR_INVALID_PARAMETER);
+  hal_ml_tensors_free (nullptr);
+
+  layout.num_tensors = 2;
+  layout.size[0] = 3;
+  layout.size[1] = 5;
+  ASSERT_EQ (hal_ml_tensors_alloc (&layout, &tensors), HAL_ML_ERROR_NONE);
+  hal_ml_tensor_memory_s *mem = (hal_ml_tensor_memory_s *) tensors;
+  EXPECT_EQ (mem[0].size, 3U);
+  EXPECT_EQ (mem[1].size, 5U);
+  EXPECT_EQ ((uintptr_t) mem[1].data % 64, 0U);
+  EXPECT_EQ (mem[2].data, nullptr);
+  hal_ml_tensors_free (tensors);
+}
+
+TEST (HAL_ML_PIPELINE, create_n)
+{
+  hal_ml_pipeline_h pipe;
+
+  EXPECT_EQ (hal_ml_pipeline_create (1, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_pipeline_create (0, &pipe), HAL_ML_ERROR_INVALID_PARAMETER);
+}
+
+TEST (HAL_ML_PIPELINE, usecase_n)
+{
+  hal_ml_pipeline_h pipe;
+  hal_ml_tensors_layout_s layout = { 0 };
+  unsigned char data[4];
+  hal_ml_tensor_memory_s input = { data, sizeof (data) };
+
+  EXPECT_EQ (hal_ml_pipeline_destroy (nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_pipeline_push (nullptr, &input, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  ASSERT_EQ (hal_ml_pipeline_create (1, &pipe), HAL_ML_ERROR_NONE);
+  /* No stage, no result callback */
+  EXPECT_EQ (hal_ml_pipeline_start (pipe), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_pipeline_push (pipe, &input, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_pipeline_set_result_cb (pipe, nullptr, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_pipeline_add_stage (pipe, nullptr, &layout, &layout, nullptr, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_pipeline_destroy (pipe), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_STREAM, usecase_n)
+{
+  hal_ml_stream_stats_s stats;
+
+  EXPECT_EQ (hal_ml_stream_start (nullptr, 1, HAL_ML_STREAM_POLICY_DROP_OLDEST, nullptr, nullptr, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_stream_push (nullptr, nullptr, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_stream_stop (nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_stream_get_stats (nullptr, &stats), HAL_ML_ERROR_INVALID_PARAMETER);
+}
+
+TEST (HAL_ML_MUX, usecase_n)
+{
+  hal_ml_mux_h mux;
+  hal_ml_mux_stats_s stats;
+  int prop = 0;
+
+  EXPECT_EQ (hal_ml_mux_create (nullptr, 1, 0, &mux), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_mux_create ("some_backend", 0, 0, &mux), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_mux_create ("some_backend", 1, 0, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_mux_destroy (nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_mux_get_stats (nullptr, &stats), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  ASSERT_EQ (hal_ml_mux_create ("some_backend", 1, 0, &mux), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_add_model (mux, nullptr, &prop, 0), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_mux_add_model (mux, "model", &prop, 0), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_invoke (mux, "unknown", nullptr, nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_NE (hal_ml_mux_invoke (mux, "model", nullptr, nullptr), HAL_ML_ERROR_NONE);
+  EXPECT_EQ (hal_ml_mux_destroy (mux), HAL_ML_ERROR_NONE);
+}
+
+TEST (HAL_ML_DAEMON, usecase_n)
+{
+  hal_ml_h ml;
+  hal_ml_server_h server;
+  hal_ml_tensors_layout_s layout = { 0 };
+  void *input, *output;
+  int prop = 0;
+
+  EXPECT_EQ (hal_ml_server_create (nullptr, &server), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_server_create ("/tmp/hal-ml-haltests.sock", nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_server_add_instance (nullptr, "name", "some_backend", &prop, &layout, &layout),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_server_destroy (nullptr), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_get_shared_tensors (nullptr, &input, &output), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  /* No daemon listens on the socket. */
+  setenv (HAL_ML_DAEMON_SOCKET_ENV, "/tmp/hal-ml-haltests-none.sock", 1);
+  EXPECT_EQ (hal_ml_create (HAL_ML_DAEMON_PREFIX "name", &ml), HAL_ML_ERROR_RUNTIME_ERROR);
+  unsetenv (HAL_ML_DAEMON_SOCKET_ENV);
+}
+
+TEST (HAL_ML_AUTO, usecase_n)
+{
+  hal_ml_h ml;
+  const char *name;
+  int prop = 0;
+
+  EXPECT_EQ (hal_ml_create_auto ("model", nullptr, nullptr, nullptr, HAL_ML_AUTO_OBJECTIVE_LATENCY, &ml),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_create_auto ("model", &prop, nullptr, nullptr, HAL_ML_AUTO_OBJECTIVE_LATENCY, nullptr),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_create_auto ("model", &prop, nullptr, nullptr, (hal_ml_auto_objective_e) 7, &ml),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_create_auto ("a\nb", &prop, nullptr, nullptr, HAL_ML_AUTO_OBJECTIVE_LATENCY, &ml),
+      HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_get_backend_name (nullptr, &name), HAL_ML_ERROR_INVALID_PARAMETER);
+}
+
+TEST (HAL_ML_PLACEMENT, usecase_n)
+{
+  hal_ml_placement_s placement = { "0", -1, 0 };
+  hal_ml_placement_stats_s stats;
+  hal_ml_tensors_layout_s layout = { 0 };
+  void *tensors;
+
+  EXPECT_EQ (hal_ml_set_placement (nullptr, &placement), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_get_placement_stats (nullptr, &stats), HAL_ML_ERROR_INVALID_PARAMETER);
+
+  layout.num_tensors = 1;
+  layout.size[0] = 4;
+  EXPECT_EQ (hal_ml_tensors_alloc_on_node (&layout, -2, &tensors), HAL_ML_ERROR_INVALID_PARAMETER);
+  EXPECT_EQ (hal_ml_tensors_alloc_on_node (nullptr, -1, &tensors), HAL_ML_ERROR_INVALID_PARAMETER);
+}
+
+TEST (HAL_ML_TILE, usecase_n)
+{
+  hal_ml_tiling_s tiling = { 1, 16, 4, 4, 8, 0, 2 };
+  unsigned char data[64];
+  hal_ml_tensor_memory_s tensors[2] = { { data, sizeof (data) }, { nullptr, 0 } };
+
+  EXPECT_EQ (hal_ml_request_invoke_tiled (nullptr, &tiling, tensors, tensors), HAL_ML_ERROR_INVALID_PARAMETER);
+}
+
 int main (int argc, char *argv[])
 {
   int ret = -1;